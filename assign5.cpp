@@ -13,40 +13,30 @@
 using namespace std;
 
 // Prototypes
-string capitalize(string s);
-string removeCharacters(string str, string remove);
+string capitalize(string_view s);
+string removeCharacters(string_view str, string_view remove);
 string addCommas(string s);
 
 // Each of the three functions below must return (NOT PRINT) 
 // a string.
 
 // Problem 1
-string capitalize(string s)
+string capitalize(string_view s)
 {
-    s = toLowerCase(s);
-    s[0] = toUpperCase(s[0]);
-    return s;
+    string res(s.length(), '\0');
+    toLowerCase(s, &res[0]);
+    if (!res.empty())
+        res[0] = toUpperCase(res[0]);
+    return res;
 }
 
 // Problem 2
-string removeCharacters(string str, string remove)
+string removeCharacters(string_view str, string_view remove)
 {
-    string res;
-    set<char> rem;
-    for (char c:remove) {
-        rem.insert(c);
-    }
-
-    bool foundAny;
+    CharClass rem(remove);
+    string res = rem.removeFrom(str);
 
-    for (char c:str) {
-        bool is_in = rem.find(c) != rem.end();
-        if (!is_in) {
-            res += c;
-        } else {
-            foundAny = true;
-        }
-    }
+    bool foundAny = res.length() != str.length();
 
     if (!foundAny)
         return "Requested string 'remove' not found.";
@@ -57,11 +47,10 @@ string removeCharacters(string str, string remove)
 // Problem 3
 string addCommas(string s)
 {
-    for (int i = s.size() - 3; i > 0; i -= 3)
-        s.insert(i, ",");
-    return s;
+    return formatWithCommas(s);
 }
 
+#ifndef BENCHMARK_BUILD
 int main()
 {    
     // Testing capitalize()
@@ -84,4 +73,5 @@ int main()
     cout << "100000: "<< addCommas("100000") << endl;
     cout << "12345678910: "<< addCommas("12345678910") << endl;
 
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
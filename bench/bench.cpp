@@ -0,0 +1,614 @@
+/*
+ * File: bench.cpp
+ * ---------------
+ * Micro-benchmarks for the string functions in assign5.cpp, the string
+ * helpers in util.h, the Lexicon and Grid classes, and, when the
+ * Makefile has USE_TIGR set, the tigr bitmap functions.  Each benchmark
+ * is run repeatedly until it has taken at least a minimum amount of
+ * time, and reports the time, the number of bytes allocated and the
+ * number of allocations per operation.
+ *
+ * Usage: bench_runner [filter]
+ *
+ * Only benchmarks whose names contain the filter are run.  The results
+ * are written to standard output as JSON, and a readable table is
+ * written to standard error.  The environment variable BENCH_MIN_TIME
+ * sets the minimum time per benchmark in seconds (default 0.2).
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include "util.h"
+#ifdef BENCH_TIGR
+#include "tigr.h"
+#endif
+
+using namespace std;
+
+/* Defined in assign5.cpp */
+string capitalize(string_view s);
+string removeCharacters(string_view str, string_view remove);
+string addCommas(string s);
+
+/*
+ * Allocation counting
+ * -------------------
+ * The global allocation functions are replaced so that every
+ * allocation made by the code under test is counted.  Some benchmarks
+ * allocate from worker threads, so the counters are atomic; relaxed
+ * increments suffice because they are only read once the threads that
+ * update them have been joined.
+ */
+
+static atomic<size_t> allocationCount(0);
+static atomic<size_t> allocatedBytes(0);
+
+static void *countedAllocation(size_t size, size_t alignment) {
+   allocationCount.fetch_add(1, memory_order_relaxed);
+   allocatedBytes.fetch_add(size, memory_order_relaxed);
+   void *p;
+   if (alignment <= alignof(max_align_t)) {
+      p = malloc(size == 0 ? 1 : size);
+   } else {
+      size_t rounded = (size + alignment - 1) / alignment * alignment;
+      p = aligned_alloc(alignment, rounded == 0 ? alignment : rounded);
+   }
+   if (p == NULL) throw bad_alloc();
+   return p;
+}
+
+void *operator new(size_t size) {
+   return countedAllocation(size, 0);
+}
+
+void *operator new[](size_t size) {
+   return countedAllocation(size, 0);
+}
+
+void *operator new(size_t size, align_val_t alignment) {
+   return countedAllocation(size, size_t(alignment));
+}
+
+void *operator new[](size_t size, align_val_t alignment) {
+   return countedAllocation(size, size_t(alignment));
+}
+
+void operator delete(void *p) noexcept {
+   free(p);
+}
+
+void operator delete[](void *p) noexcept {
+   free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+   free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+   free(p);
+}
+
+void operator delete(void *p, align_val_t) noexcept {
+   free(p);
+}
+
+void operator delete[](void *p, align_val_t) noexcept {
+   free(p);
+}
+
+void operator delete(void *p, size_t, align_val_t) noexcept {
+   free(p);
+}
+
+void operator delete[](void *p, size_t, align_val_t) noexcept {
+   free(p);
+}
+
+/*
+ * Keeps the compiler from discarding a result that is never used.
+ */
+template <typename T>
+static void keep(const T& value) {
+#if defined(__GNUC__)
+   asm volatile("" : : "r,m"(value) : "memory");
+#else
+   static volatile const T *sink;
+   sink = &value;
+#endif
+}
+
+/*
+ * Benchmark harness
+ * -----------------
+ * run calls fn(n) with growing values of n until a call takes at
+ * least the minimum time; fn must perform the operation n times.
+ */
+
+struct BenchResult {
+   string name;
+   size_t inputBytes;
+   long iterations;
+   double nsPerOp;
+   double bytesPerOp;
+   double allocsPerOp;
+};
+
+static vector<BenchResult> results;
+static string filter;
+static double minTime = 0.2;
+
+template <typename Fn>
+static void run(const string& name, size_t inputBytes, Fn fn) {
+   if (name.find(filter) == string::npos) return;
+   fn(1);
+   long n = 1;
+   while (true) {
+      size_t startCount = allocationCount;
+      size_t startBytes = allocatedBytes;
+      auto start = chrono::steady_clock::now();
+      fn(n);
+      double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+      size_t allocations = allocationCount - startCount;
+      size_t bytes = allocatedBytes - startBytes;
+      if (elapsed >= minTime || n >= (1L << 40)) {
+         BenchResult result;
+         result.name = name;
+         result.inputBytes = inputBytes;
+         result.iterations = n;
+         result.nsPerOp = elapsed * 1e9 / n;
+         result.bytesPerOp = double(bytes) / n;
+         result.allocsPerOp = double(allocations) / n;
+         results.push_back(result);
+         fprintf(stderr, "%-40s %10zu B %14.1f ns/op %14.1f B/op %10.2f allocs/op\n",
+                 name.c_str(), inputBytes, result.nsPerOp,
+                 result.bytesPerOp, result.allocsPerOp);
+         return;
+      }
+      double scale = (elapsed > 0) ? 1.2 * minTime / elapsed : 100;
+      n = long(n * min(100.0, max(2.0, scale)));
+   }
+}
+
+static void writeJson(ostream& os) {
+   os << "[\n";
+   for (size_t i = 0; i < results.size(); i++) {
+      const BenchResult& r = results[i];
+      char line[256];
+      snprintf(line, sizeof line,
+               "  {\"name\": \"%s\", \"input_bytes\": %zu, \"iterations\": %ld, "
+               "\"ns_per_op\": %.3f, \"bytes_per_op\": %.3f, \"allocs_per_op\": %.3f}",
+               r.name.c_str(), r.inputBytes, r.iterations,
+               r.nsPerOp, r.bytesPerOp, r.allocsPerOp);
+      os << line << (i + 1 < results.size() ? ",\n" : "\n");
+   }
+   os << "]\n";
+}
+
+/*
+ * Input generation
+ * ----------------
+ * All inputs come from a fixed seed so that runs are comparable.
+ */
+
+static mt19937 rng(20221014);
+
+static string randomText(size_t length) {
+   static const char letters[] = "abcdefghijklmnopqrstuvwxyz"
+                                 "ABCDEFGHIJKLMNOPQRSTUVWXYZ     ";
+   string text(length, ' ');
+   for (char& ch : text) {
+      ch = letters[rng() % (sizeof letters - 1)];
+   }
+   return text;
+}
+
+/* Greek letters of both cases, with spaces, about length bytes long */
+static string randomGreek(size_t length) {
+   string text;
+   while (text.length() + 2 <= length) {
+      if (rng() % 6 == 0) {
+         text += ' ';
+      } else {
+         unsigned cp = (rng() % 2 ? 0x391 : 0x3B1) + rng() % 17;
+         text += char(0xC0 | (cp >> 6));
+         text += char(0x80 | (cp & 0x3F));
+      }
+   }
+   return text;
+}
+
+static string randomDigits(size_t length) {
+   string digits(length, '0');
+   for (char& ch : digits) {
+      ch = char('0' + rng() % 10);
+   }
+   if (length > 0) digits[0] = '1';
+   return digits;
+}
+
+static string randomWord() {
+   int length = 3 + rng() % 10;
+   string word(length, 'a');
+   for (char& ch : word) {
+      ch = char('a' + rng() % 26);
+   }
+   return word;
+}
+
+static const size_t SIZES[] = {
+   10, 100, 1000, 10000, 100000, 1000000, 10000000
+};
+
+static string sizeName(size_t bytes) {
+   if (bytes >= 1000000) return to_string(bytes / 1000000) + "MB";
+   if (bytes >= 1000) return to_string(bytes / 1000) + "KB";
+   return to_string(bytes) + "B";
+}
+
+/*
+ * Benchmarks
+ * ----------
+ */
+
+static void benchStrings() {
+   CharClass vowels("aeiou");
+   StringPipeline pipeline = StringPipeline().trim().lower().remove("aeiou").build();
+   for (size_t size : SIZES) {
+      string text = randomText(size);
+      string padded = "   " + text.substr(0, size > 6 ? size - 6 : 0) + "   ";
+      string digits = randomDigits(size);
+      string greek = randomGreek(size);
+      string suffix = "/" + sizeName(size);
+
+      run("capitalize" + suffix, size, [&](long n) {
+         for (long i = 0; i < n; i++) keep(capitalize(text));
+      });
+      run("removeCharacters" + suffix, size, [&](long n) {
+         for (long i = 0; i < n; i++) keep(removeCharacters(text, "aeiou"));
+      });
+      run("addCommas" + suffix, size, [&](long n) {
+         for (long i = 0; i < n; i++) keep(addCommas(digits));
+      });
+      run("toLowerCase" + suffix, size, [&](long n) {
+         for (long i = 0; i < n; i++) keep(toLowerCase(text));
+      });
+      run("toUpperCase" + suffix, size, [&](long n) {
+         for (long i = 0; i < n; i++) keep(toUpperCase(text));
+      });
+      run("toLowerCaseUtf8.ascii" + suffix, size, [&](long n) {
+         for (long i = 0; i < n; i++) keep(toLowerCaseUtf8(text));
+      });
+      run("toLowerCaseUtf8.greek" + suffix, greek.length(), [&](long n) {
+         for (long i = 0; i < n; i++) keep(toLowerCaseUtf8(greek));
+      });
+      string buffer(size, '\0');
+      run("toLowerCase.buffer" + suffix, size, [&](long n) {
+         for (long i = 0; i < n; i++) {
+            toLowerCase(text, &buffer[0]);
+            keep(buffer[0]);
+         }
+      });
+      run("trim" + suffix, size, [&](long n) {
+         for (long i = 0; i < n; i++) keep(trim(padded));
+      });
+      run("trimView" + suffix, size, [&](long n) {
+         for (long i = 0; i < n; i++) keep(trimView(padded));
+      });
+      run("chain.trim.lower.remove" + suffix, size, [&](long n) {
+         for (long i = 0; i < n; i++) keep(vowels.removeFrom(toLowerCase(trim(padded))));
+      });
+      run("StringPipeline.trim.lower.remove" + suffix, size, [&](long n) {
+         for (long i = 0; i < n; i++) keep(pipeline.apply(padded));
+      });
+   }
+}
+
+static void benchRecords() {
+   StringPipeline pipeline = StringPipeline().trim().capitalize().remove("aeiou").build();
+   string text;
+   vector<string_view> records;
+   while (text.length() < 10000000) {
+      text += randomText(5 + rng() % 60);
+      text += '\n';
+   }
+   size_t pos = 0;
+   while (pos < text.length()) {
+      size_t newline = text.find('\n', pos);
+      records.emplace_back(text.data() + pos, newline - pos);
+      pos = newline + 1;
+   }
+   run("records.loop/10MB", text.length(), [&](long n) {
+      for (long i = 0; i < n; i++) {
+         vector<string> results;
+         results.reserve(records.size());
+         for (string_view record : records) results.push_back(pipeline.apply(record));
+         keep(results.size());
+      }
+   });
+   run("records.applyToRecords/10MB", text.length(), [&](long n) {
+      for (long i = 0; i < n; i++) keep(pipeline.applyToRecords(text).size());
+   });
+}
+
+static void benchLexicon() {
+   const int N_WORDS = 200000;
+   vector<string> words;
+   for (int i = 0; i < N_WORDS; i++) {
+      words.push_back(randomWord());
+   }
+   Lexicon lex;
+   for (const string& word : words) {
+      lex.add(word);
+   }
+   lex.compact();
+   string dawgFile = "bench_lexicon.dat";
+   string nativeFile = "bench_lexicon.dawg2";
+   string textFile = "bench_lexicon.txt";
+   lex.saveBinary(dawgFile);
+   lex.saveNativeBinary(nativeFile);
+   {
+      ofstream out(textFile);
+      for (const string& word : words) out << word << '\n';
+   }
+   size_t textBytes = 0;
+   for (const string& word : words) {
+      textBytes += word.length() + 1;
+   }
+
+   run("Lexicon.load.text", textBytes, [&](long n) {
+      for (long i = 0; i < n; i++) {
+         Lexicon loaded(textFile);
+         keep(loaded.size());
+      }
+   });
+   run("Lexicon.load.dawg", textBytes, [&](long n) {
+      for (long i = 0; i < n; i++) {
+         Lexicon loaded(dawgFile);
+         keep(loaded.size());
+      }
+   });
+   run("Lexicon.load.dawg2", textBytes, [&](long n) {
+      for (long i = 0; i < n; i++) {
+         Lexicon loaded(nativeFile);
+         keep(loaded.size());
+      }
+   });
+
+   const int N_QUERIES = 4096;
+   vector<string> hits, misses, prefixes;
+   for (int i = 0; i < N_QUERIES; i++) {
+      hits.push_back(words[rng() % words.size()]);
+      misses.push_back(randomWord() + "q");
+      prefixes.push_back(hits.back().substr(0, 1 + rng() % hits.back().length()));
+   }
+   run("Lexicon.contains.hit", 0, [&](long n) {
+      for (long i = 0; i < n; i++) keep(lex.contains(hits[i % N_QUERIES]));
+   });
+   run("Lexicon.contains.miss", 0, [&](long n) {
+      for (long i = 0; i < n; i++) keep(lex.contains(misses[i % N_QUERIES]));
+   });
+   run("Lexicon.containsPrefix", 0, [&](long n) {
+      for (long i = 0; i < n; i++) keep(lex.containsPrefix(prefixes[i % N_QUERIES]));
+   });
+   run("Lexicon.forEachWord", textBytes, [&](long n) {
+      for (long i = 0; i < n; i++) {
+         size_t total = 0;
+         lex.forEachWord([&total](string_view word) { total += word.length(); });
+         keep(total);
+      }
+   });
+   run("Lexicon.iterator", textBytes, [&](long n) {
+      for (long i = 0; i < n; i++) {
+         size_t total = 0;
+         for (const string& word : lex) total += word.length();
+         keep(total);
+      }
+   });
+   remove(dawgFile.c_str());
+   remove(nativeFile.c_str());
+   remove(textFile.c_str());
+}
+
+static void benchGrid() {
+   for (size_t size : SIZES) {
+      if (size < sizeof(int)) continue;
+      int side = max(1, int(sqrt(double(size / sizeof(int)))));
+      string suffix = "/" + sizeName(size);
+      size_t bytes = size_t(side) * side * sizeof(int);
+
+      run("Grid.resize" + suffix, bytes, [&](long n) {
+         for (long i = 0; i < n; i++) {
+            Grid<int> grid;
+            grid.resize(side, side);
+            keep(grid.data());
+         }
+      });
+      Grid<int> grid(side, side);
+      run("Grid.resize.reuse" + suffix, bytes, [&](long n) {
+         for (long i = 0; i < n; i++) {
+            grid.resize(side, side);
+            keep(grid.data());
+         }
+      });
+      run("Grid.resize.retain" + suffix, bytes, [&](long n) {
+         for (long i = 0; i < n; i++) {
+            grid.resize(side, side + (i & 1), true);
+            keep(grid.data());
+         }
+      });
+      grid.resize(side, side);
+      run("Grid.subscript" + suffix, bytes, [&](long n) {
+         for (long i = 0; i < n; i++) {
+            long total = 0;
+            for (int r = 0; r < side; r++) {
+               for (int c = 0; c < side; c++) total += grid[r][c];
+            }
+            keep(total);
+         }
+      });
+      run("Grid.row" + suffix, bytes, [&](long n) {
+         for (long i = 0; i < n; i++) {
+            long total = 0;
+            for (int r = 0; r < side; r++) {
+               for (int value : grid.row(r)) total += value;
+            }
+            keep(total);
+         }
+      });
+   }
+}
+
+#ifdef BENCH_TIGR
+
+/*
+ * Draws into a 4K frame, and decodes PNG images, with each SIMD
+ * instruction set that tigrSetSimd accepts on this machine, so the
+ * kernels can be compared with the scalar code.  The text case blits a
+ * strip that is mostly transparent, as a line of glyphs is.  The atlas
+ * is a 1024x1024 image written by tigrSaveImage, and the font is the
+ * one in the font directory, when the benchmarks run from the top of
+ * the tree.
+ */
+static void benchBitmaps() {
+   const int W = 3840, H = 2160, CELL = 16, LINE = 32;
+   size_t frameBytes = size_t(W) * H * sizeof(TPixel);
+   Tigr *frame = tigrBitmap(W, H);
+   Tigr *image = tigrBitmap(W, H);
+   Tigr *text = tigrBitmap(W, LINE);
+   for (int i = 0; i < W * H; i++) {
+      image->pix[i] = tigrRGBA(rng() & 255, rng() & 255, rng() & 255, rng() & 255);
+   }
+   for (int i = 0; i < W * LINE; i++) {
+      unsigned alpha = (rng() % 5 == 0) ? ((rng() & 1) ? 255 : rng() & 255) : 0;
+      text->pix[i] = tigrRGBA(255, 255, 255, alpha);
+   }
+   const int ATLAS = 1024;
+   Tigr *atlas = tigrBitmap(ATLAS, ATLAS);
+   for (int y = 0; y < ATLAS; y++) {
+      for (int x = 0; x < ATLAS; x++) {
+         atlas->pix[y * ATLAS + x] = tigrRGBA(x, y, (x ^ y) & 0xf0, (x / 16 + y / 16) % 3 * 127);
+      }
+   }
+   string atlasFile = "bench_atlas.png";
+   tigrSaveImage(atlasFile.c_str(), atlas);
+   tigrFree(atlas);
+   ifstream atlasStream(atlasFile, ios::binary);
+   string atlasPng((istreambuf_iterator<char>(atlasStream)), istreambuf_iterator<char>());
+   ifstream fontStream("font/Roboto-Regular.png", ios::binary);
+   string fontPng((istreambuf_iterator<char>(fontStream)), istreambuf_iterator<char>());
+   const struct { int level; const char *name; } LEVELS[] = {
+      { TIGR_SIMD_SCALAR, "scalar" },
+      { TIGR_SIMD_SSE2, "sse2" },
+      { TIGR_SIMD_AVX2, "avx2" },
+      { TIGR_SIMD_NEON, "neon" },
+   };
+   for (const auto& level : LEVELS) {
+      if (tigrSetSimd(level.level) != level.level) continue;
+      string suffix = string(".") + level.name + "/4K";
+      run("tigrClear" + suffix, frameBytes, [&](long n) {
+         for (long i = 0; i < n; i++) tigrClear(frame, tigrRGB(i & 255, 0, 0));
+      });
+      run("tigrFill.cells" + suffix, frameBytes, [&](long n) {
+         for (long i = 0; i < n; i++) {
+            for (int y = 0; y < H; y += CELL) {
+               for (int x = 0; x < W; x += CELL) {
+                  tigrFill(frame, x, y, CELL - 1, CELL - 1, tigrRGB(x & 255, y & 255, 0));
+               }
+            }
+         }
+      });
+      run("tigrBlitAlpha" + suffix, frameBytes, [&](long n) {
+         for (long i = 0; i < n; i++) tigrBlitAlpha(frame, image, 0, 0, 0, 0, W, H, 0.5f);
+      });
+      run("tigrBlitTint" + suffix, frameBytes, [&](long n) {
+         TPixel tint = tigrRGBA(255, 128, 64, 255);
+         for (long i = 0; i < n; i++) tigrBlitTint(frame, image, 0, 0, 0, 0, W, H, tint);
+      });
+      run("tigrBlitTint.text" + suffix, frameBytes, [&](long n) {
+         TPixel tint = tigrRGB(0, 200, 255);
+         for (long i = 0; i < n; i++) {
+            for (int y = 0; y < H; y += LINE) {
+               tigrBlitTint(frame, text, 0, y, 0, 0, W, LINE, tint);
+            }
+         }
+      });
+      string pngSuffix = string(".") + level.name;
+      run("tigrLoadImageMem.atlas" + pngSuffix, atlasPng.length(), [&](long n) {
+         for (long i = 0; i < n; i++) {
+            tigrFree(tigrLoadImageMem(atlasPng.data(), int(atlasPng.length())));
+         }
+      });
+      if (fontPng.empty()) continue;
+      run("tigrLoadImageMem.font" + pngSuffix, fontPng.length(), [&](long n) {
+         for (long i = 0; i < n; i++) {
+            tigrFree(tigrLoadImageMem(fontPng.data(), int(fontPng.length())));
+         }
+      });
+   }
+   remove(atlasFile.c_str());
+   tigrSetSimd(TIGR_SIMD_AUTO);
+
+   // A label in every cell of a grid over the frame, as a spreadsheet
+   // view redraws them each frame.
+   const int LABEL_W = 120, LABEL_H = 16;
+   vector<string> labels;
+   vector<TigrText> queued;
+   size_t labelBytes = 0;
+   for (int y = 0; y + LABEL_H <= H; y += LABEL_H) {
+      for (int x = 0; x + LABEL_W <= W; x += LABEL_W) {
+         labels.push_back(formatWithCommas(long(rng() % 100000000)));
+         labelBytes += labels.back().length();
+      }
+   }
+   for (size_t i = 0, x = 0, y = 0; i < labels.size(); i++) {
+      TigrText t = { int(x), int(y), tigrRGB(220, 220, 220), labels[i].c_str() };
+      queued.push_back(t);
+      x += LABEL_W;
+      if (x + LABEL_W > size_t(W)) x = 0, y += LABEL_H;
+   }
+   run("tigrPrint.labels/4K", labelBytes, [&](long n) {
+      for (long i = 0; i < n; i++) {
+         for (const TigrText& t : queued) tigrPrint(frame, tfont, t.x, t.y, t.color, "%s", t.text);
+      }
+   });
+   run("tigrPrintMany.labels/4K", labelBytes, [&](long n) {
+      for (long i = 0; i < n; i++) tigrPrintMany(frame, tfont, queued.data(), int(queued.size()));
+   });
+   run("tigrTextWidth.labels", labelBytes, [&](long n) {
+      for (long i = 0; i < n; i++) {
+         int total = 0;
+         for (const TigrText& t : queued) total += tigrTextWidth(tfont, t.text);
+         keep(total);
+      }
+   });
+   tigrFree(text);
+   tigrFree(image);
+   tigrFree(frame);
+}
+
+#endif
+
+int main(int argc, char *argv[]) {
+   if (argc > 1) filter = argv[1];
+   const char *minTimeSetting = getenv("BENCH_MIN_TIME");
+   if (minTimeSetting != NULL) minTime = atof(minTimeSetting);
+   benchStrings();
+   benchRecords();
+   benchLexicon();
+   benchGrid();
+#ifdef BENCH_TIGR
+   benchBitmaps();
+#endif
+   writeJson(cout);
+   return 0;
+}
@@ -207,6 +207,19 @@ enum TIGRBlitMode {
 // Set destination bitmap blend mode for blit operations.
 void tigrBlitMode(Tigr *dest, int mode);
 
+// SIMD instruction sets for the pixel kernels.
+#define TIGR_SIMD_AUTO   -1  // the widest set the CPU supports (default)
+#define TIGR_SIMD_SCALAR 0   // plain C, one pixel at a time
+#define TIGR_SIMD_SSE2   1   // 4 pixels per step
+#define TIGR_SIMD_AVX2   2   // 8 pixels per step
+#define TIGR_SIMD_NEON   3   // 4 pixels per step
+
+// Chooses the instruction set used by tigrClear, tigrFill, tigrBlitTint,
+// tigrBlitAlpha and the PNG row filters, and returns the set actually in use.
+// If the CPU lacks the requested set, the widest one it supports is used.
+// Every set produces the same pixels; this exists to compare them.
+int tigrSetSimd(int level);
+
 // Helper for making colors.
 TIGR_INLINE TPixel tigrRGB(unsigned char r, unsigned char g, unsigned char b)
 {
@@ -226,10 +239,13 @@ typedef struct {
     int code, x, y, w, h;
 } TigrGlyph;
 
+typedef struct TigrFontCache TigrFontCache;
+
 typedef struct {
     Tigr *bitmap;
     int numGlyphs;
     TigrGlyph *glyphs;
+    TigrFontCache *cache;   // Glyph table and text layouts, built on first use.
 } TigrFont;
 
 // Loads a font. The font bitmap should contain all characters
@@ -242,12 +258,37 @@ TigrFont *tigrLoadFont(Tigr *bitmap, int codepage);
 // Frees a font.
 void tigrFreeFont(TigrFont *font);
 
+// Frees the glyph table and text layouts cached for a font, which are
+// built again as it is used. Call it after changing the font's bitmap or
+// glyphs, or to give back the memory, such as for the never-freed tfont.
+// NOTE:
+//  A font's layouts and pre-rendered strings are limited to
+//  TIGR_FONT_CACHE_BYTES (16 MB unless defined when compiling tigr.c);
+//  when they would exceed it they are all dropped. The glyph table adds
+//  4 bytes per code point up to the font's highest one (about 34 KB for
+//  codepage 1252), and the lookup sets take 64 KB.
+void tigrFlushFontCache(TigrFont *font);
+
 // Prints UTF-8 text onto a bitmap.
 // NOTE:
 //  This uses the target bitmap blit mode.
 //  See tigrBlitTint for details.
 void tigrPrint(Tigr *dest, TigrFont *font, int x, int y, TPixel color, const char *text, ...);
 
+// A string queued for tigrPrintMany.
+typedef struct {
+    int x, y;
+    TPixel color;
+    const char *text;
+} TigrText;
+
+// Prints a batch of UTF-8 strings onto a bitmap in one pass.
+// Unlike tigrPrint the strings are printed as is, not as format strings.
+// NOTE:
+//  Layouts of recently printed strings are cached per font, so labels
+//  that are redrawn every frame are cheaper to print than to format.
+void tigrPrintMany(Tigr *dest, TigrFont *font, const TigrText *texts, int count);
+
 // Returns the width/height of a string.
 int tigrTextWidth(TigrFont *font, const char *text);
 int tigrTextHeight(TigrFont *font, const char *text);
@@ -304,6 +345,13 @@ void tigrShowKeyboard(int show);
 Tigr *tigrLoadImage(const char *fileName);
 Tigr *tigrLoadImageMem(const void *data, int length);
 
+// Sets a directory in which tigrLoadImage keeps decoded copies of the
+// images it loads, so that loading the same PNG again skips decoding.
+// Entries are named after a hash of the PNG data, so a changed file
+// gets a new entry; old entries are never removed.
+// The directory must exist. Pass NULL to turn the cache off (default).
+void tigrSetImageCache(const char *dirName);
+
 // Saves a PNG to a file. (fileName is UTF-8)
 // On error, returns zero and sets errno.
 int tigrSaveImage(const char *fileName, Tigr *bmp);
@@ -22,6 +22,11 @@
 /* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
 /*************************************************************************/
 
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -68,94 +73,1844 @@ void pause_ms(int millis) {
     std::this_thread::sleep_for(std::chrono::milliseconds(millis));
 }
 
+/* instrumentation ------------------------------------*/
+
+#include <map>
+#include <new>
+
+/*
+ * Implementation notes: instrumentation
+ * -------------------------------------
+ * Each counter is pushed onto a lock-free list when its function first
+ * runs; the list head is constant-initialized, so counters may be
+ * registered during static initialization.  The snapshot merges the
+ * counters that share a name, such as those of the instantiations of
+ * a Grid template for different element types.
+ */
+
+#ifdef WCLIB_INSTRUMENT
+
+thread_local InstrumentThreadCounts instrumentThreadCounts = { 0, 0 };
+
+static std::atomic<InstrumentCounter *> instrumentCounters(NULL);
+
+InstrumentCounter::InstrumentCounter(const char *name)
+   : name(name), calls(0), ticks(0), allocations(0), allocatedBytes(0) {
+   next = instrumentCounters.load(std::memory_order_relaxed);
+   while (!instrumentCounters.compare_exchange_weak(next, this,
+                                                    std::memory_order_release,
+                                                    std::memory_order_relaxed)) {
+      /* Retry with the updated head */
+   }
+}
+
+void instrumentRecordAllocation(size_t size) {
+   instrumentThreadCounts.allocations++;
+   instrumentThreadCounts.allocatedBytes += size;
+}
+
+std::vector<InstrumentSample> instrumentSnapshot() {
+   std::map<std::string, InstrumentSample> merged;
+   InstrumentCounter *counter = instrumentCounters.load(std::memory_order_acquire);
+   for (; counter != NULL; counter = counter->next) {
+      InstrumentSample& sample = merged[counter->name];
+      sample.name = counter->name;
+      sample.calls += counter->calls.load(std::memory_order_relaxed);
+      sample.ticks += counter->ticks.load(std::memory_order_relaxed);
+      sample.allocations += counter->allocations.load(std::memory_order_relaxed);
+      sample.allocatedBytes += counter->allocatedBytes.load(std::memory_order_relaxed);
+   }
+   std::vector<InstrumentSample> samples;
+   for (auto& entry : merged) {
+      if (entry.second.calls != 0) samples.push_back(entry.second);
+   }
+   return samples;
+}
+
+void instrumentReset() {
+   InstrumentCounter *counter = instrumentCounters.load(std::memory_order_acquire);
+   for (; counter != NULL; counter = counter->next) {
+      counter->calls.store(0, std::memory_order_relaxed);
+      counter->ticks.store(0, std::memory_order_relaxed);
+      counter->allocations.store(0, std::memory_order_relaxed);
+      counter->allocatedBytes.store(0, std::memory_order_relaxed);
+   }
+}
+
+#ifndef WCLIB_INSTRUMENT_NO_NEW
+
+/*
+ * Replacements for the global allocation functions, which record each
+ * allocation before passing it on to malloc.
+ */
+
+static void *instrumentedAllocation(size_t size, size_t alignment) {
+   instrumentRecordAllocation(size);
+   void *p;
+   if (alignment <= alignof(std::max_align_t)) {
+      p = malloc(size == 0 ? 1 : size);
+   } else {
+      size_t rounded = (size + alignment - 1) / alignment * alignment;
+      p = aligned_alloc(alignment, rounded == 0 ? alignment : rounded);
+   }
+   if (p == NULL) throw std::bad_alloc();
+   return p;
+}
+
+void *operator new(size_t size) {
+   return instrumentedAllocation(size, 0);
+}
+
+void *operator new[](size_t size) {
+   return instrumentedAllocation(size, 0);
+}
+
+void *operator new(size_t size, std::align_val_t alignment) {
+   return instrumentedAllocation(size, size_t(alignment));
+}
+
+void *operator new[](size_t size, std::align_val_t alignment) {
+   return instrumentedAllocation(size, size_t(alignment));
+}
+
+void operator delete(void *p) noexcept {
+   free(p);
+}
+
+void operator delete[](void *p) noexcept {
+   free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+   free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+   free(p);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept {
+   free(p);
+}
+
+void operator delete[](void *p, std::align_val_t) noexcept {
+   free(p);
+}
+
+void operator delete(void *p, size_t, std::align_val_t) noexcept {
+   free(p);
+}
+
+void operator delete[](void *p, size_t, std::align_val_t) noexcept {
+   free(p);
+}
+
+#endif
+
+#else
+
+void instrumentRecordAllocation(size_t) {
+   /* Empty */
+}
+
+std::vector<InstrumentSample> instrumentSnapshot() {
+   return std::vector<InstrumentSample>();
+}
+
+void instrumentReset() {
+   /* Empty */
+}
+
+#endif
+
+std::string instrumentToPrometheus() {
+   static const struct {
+      const char *metric;
+      const char *help;
+      uint64_t InstrumentSample::*field;
+   } METRICS[] = {
+      { "wclib_calls_total", "Calls to the function.", &InstrumentSample::calls },
+      { "wclib_ticks_total", "Ticks spent in the function.", &InstrumentSample::ticks },
+      { "wclib_allocations_total", "Heap allocations made by the function.",
+        &InstrumentSample::allocations },
+      { "wclib_allocated_bytes_total", "Bytes allocated by the function.",
+        &InstrumentSample::allocatedBytes },
+   };
+   std::vector<InstrumentSample> samples = instrumentSnapshot();
+   std::ostringstream os;
+   for (const auto& metric : METRICS) {
+      os << "# HELP " << metric.metric << " " << metric.help << "\n";
+      os << "# TYPE " << metric.metric << " counter\n";
+      for (const InstrumentSample& sample : samples) {
+         os << metric.metric << "{function=\"" << sample.name << "\"} "
+            << sample.*metric.field << "\n";
+      }
+   }
+   return os.str();
+}
+
+std::string instrumentToJson() {
+   std::vector<InstrumentSample> samples = instrumentSnapshot();
+   std::ostringstream os;
+   os << "{\"functions\": [";
+   for (size_t i = 0; i < samples.size(); i++) {
+      const InstrumentSample& sample = samples[i];
+      if (i > 0) os << ", ";
+      os << "{\"name\": \"" << sample.name << "\", \"calls\": " << sample.calls
+         << ", \"ticks\": " << sample.ticks
+         << ", \"allocations\": " << sample.allocations
+         << ", \"allocated_bytes\": " << sample.allocatedBytes << "}";
+   }
+   os << "]}";
+   return os.str();
+}
+
 /* strings --------------------------------------------*/
 
-bool startsWith(const std::string& str, char prefix) {
-    return str.length() > 0 && str[0] == prefix;
+char toLowerCase(char ch) {
+    return (char) tolower((unsigned char) ch);
 }
 
-bool startsWith(const std::string& str, const std::string& prefix) {
-    if (str.length() < prefix.length()) return false;
-    int nChars = prefix.length();
-    for (int i = 0; i < nChars; i++) {
-        if (str[i] != prefix[i]) return false;
-    }
-    return true;
+/*
+ * Implementation notes: case conversion
+ * -------------------------------------
+ * Case conversion is done by a kernel that handles ASCII text a block at
+ * a time and falls back to the locale-aware tolower/toupper only for
+ * bytes outside the ASCII range.  ASCII letters are therefore always
+ * converted the ASCII way, whatever the current C locale.
+ *
+ * The widest kernel the processor supports (AVX-512BW, AVX2, SSE2 or
+ * NEON) is chosen once, on first use.  Each kernel converts blocks of
+ * 64, 32 or 16 bytes with a range compare and an exclusive-or of the
+ * 0x20 case bit; a block containing any non-ASCII byte, and the final
+ * partial block, go through the portable scalar kernel.  That kernel
+ * applies the same idea to eight bytes at a time in a 64-bit word,
+ * without branches, and visits bytes individually only in words that
+ * contain non-ASCII bytes.
+ *
+ * Every kernel reads a block before writing it, so the source and
+ * destination may be the same buffer.
+ */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define UTIL_CASE_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define UTIL_CASE_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+   typedef void (*CaseKernel)(const unsigned char *src, unsigned char *dst,
+                              size_t n, bool toUpper);
+
+   inline unsigned char convertCaseByte(unsigned char ch, unsigned char first,
+                                        bool toUpper) {
+      if (ch & 0x80) return toUpper ? toupper(ch) : tolower(ch);
+      return ch ^ (((unsigned char) (ch - first) < 26) << 5);
+   }
+
+   void convertCaseScalar(const unsigned char *src, unsigned char *dst,
+                          size_t n, bool toUpper) {
+      const uint64_t ONES = 0x0101010101010101ULL;
+      const uint64_t HIGH = 0x8080808080808080ULL;
+      unsigned char first = toUpper ? 'a' : 'A';
+      uint64_t fromFirst = (0x80 - first) * ONES;
+      uint64_t pastLast = (0x80 - (first + 26)) * ONES;
+      size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+         uint64_t word;
+         memcpy(&word, src + i, 8);
+         if ((word & HIGH) == 0) {
+            uint64_t inRange = (word + fromFirst) & ~(word + pastLast) & HIGH;
+            word ^= inRange >> 2;
+            memcpy(dst + i, &word, 8);
+         } else {
+            for (size_t k = i; k < i + 8; k++) {
+               dst[k] = convertCaseByte(src[k], first, toUpper);
+            }
+         }
+      }
+      for (; i < n; i++) {
+         dst[i] = convertCaseByte(src[i], first, toUpper);
+      }
+   }
+
+#ifdef UTIL_CASE_X86
+
+   __attribute__((target("sse2")))
+   void convertCaseSSE2(const unsigned char *src, unsigned char *dst,
+                        size_t n, bool toUpper) {
+      const __m128i shift = _mm_set1_epi8((char) (0x80 - (toUpper ? 'a' : 'A')));
+      const __m128i limit = _mm_set1_epi8((char) (-128 + 26));
+      const __m128i caseBit = _mm_set1_epi8(0x20);
+      size_t i = 0;
+      for (; i + 16 <= n; i += 16) {
+         __m128i v = _mm_loadu_si128((const __m128i *) (src + i));
+         if (_mm_movemask_epi8(v) != 0) {
+            convertCaseScalar(src + i, dst + i, 16, toUpper);
+            continue;
+         }
+         __m128i inRange = _mm_cmplt_epi8(_mm_add_epi8(v, shift), limit);
+         v = _mm_xor_si128(v, _mm_and_si128(inRange, caseBit));
+         _mm_storeu_si128((__m128i *) (dst + i), v);
+      }
+      convertCaseScalar(src + i, dst + i, n - i, toUpper);
+   }
+
+   __attribute__((target("avx2")))
+   void convertCaseAVX2(const unsigned char *src, unsigned char *dst,
+                        size_t n, bool toUpper) {
+      const __m256i shift = _mm256_set1_epi8((char) (0x80 - (toUpper ? 'a' : 'A')));
+      const __m256i limit = _mm256_set1_epi8((char) (-128 + 26));
+      const __m256i caseBit = _mm256_set1_epi8(0x20);
+      size_t i = 0;
+      for (; i + 32 <= n; i += 32) {
+         __m256i v = _mm256_loadu_si256((const __m256i *) (src + i));
+         if (_mm256_movemask_epi8(v) != 0) {
+            convertCaseScalar(src + i, dst + i, 32, toUpper);
+            continue;
+         }
+         __m256i inRange = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(v, shift));
+         v = _mm256_xor_si256(v, _mm256_and_si256(inRange, caseBit));
+         _mm256_storeu_si256((__m256i *) (dst + i), v);
+      }
+      convertCaseSSE2(src + i, dst + i, n - i, toUpper);
+   }
+
+   __attribute__((target("avx512f,avx512bw")))
+   void convertCaseAVX512(const unsigned char *src, unsigned char *dst,
+                          size_t n, bool toUpper) {
+      const __m512i shift = _mm512_set1_epi8((char) (0x80 - (toUpper ? 'a' : 'A')));
+      const __m512i limit = _mm512_set1_epi8((char) (-128 + 26));
+      const __m512i caseBit = _mm512_set1_epi8(0x20);
+      size_t i = 0;
+      for (; i + 64 <= n; i += 64) {
+         __m512i v = _mm512_loadu_si512((const void *) (src + i));
+         if (_mm512_movepi8_mask(v) != 0) {
+            convertCaseScalar(src + i, dst + i, 64, toUpper);
+            continue;
+         }
+         __mmask64 inRange = _mm512_cmplt_epi8_mask(_mm512_add_epi8(v, shift), limit);
+         v = _mm512_xor_si512(v, _mm512_maskz_mov_epi8(inRange, caseBit));
+         _mm512_storeu_si512((void *) (dst + i), v);
+      }
+      convertCaseAVX2(src + i, dst + i, n - i, toUpper);
+   }
+
+#endif // UTIL_CASE_X86
+
+#ifdef UTIL_CASE_NEON
+
+   void convertCaseNEON(const unsigned char *src, unsigned char *dst,
+                        size_t n, bool toUpper) {
+      const uint8x16_t first = vdupq_n_u8(toUpper ? 'a' : 'A');
+      const uint8x16_t span = vdupq_n_u8(26);
+      const uint8x16_t caseBit = vdupq_n_u8(0x20);
+      size_t i = 0;
+      for (; i + 16 <= n; i += 16) {
+         uint8x16_t v = vld1q_u8(src + i);
+         if (vmaxvq_u8(v) >= 0x80) {
+            convertCaseScalar(src + i, dst + i, 16, toUpper);
+            continue;
+         }
+         uint8x16_t inRange = vcltq_u8(vsubq_u8(v, first), span);
+         vst1q_u8(dst + i, veorq_u8(v, vandq_u8(inRange, caseBit)));
+      }
+      convertCaseScalar(src + i, dst + i, n - i, toUpper);
+   }
+
+#endif // UTIL_CASE_NEON
+
+   CaseKernel selectCaseKernel() {
+#if defined(UTIL_CASE_X86)
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx512bw")) return convertCaseAVX512;
+      if (__builtin_cpu_supports("avx2")) return convertCaseAVX2;
+      if (__builtin_cpu_supports("sse2")) return convertCaseSSE2;
+#elif defined(UTIL_CASE_NEON)
+      return convertCaseNEON;
+#endif
+      return convertCaseScalar;
+   }
+
+   void convertCase(std::string_view str, char *dst, bool toUpper) {
+      static const CaseKernel kernel = selectCaseKernel();
+      kernel((const unsigned char *) str.data(), (unsigned char *) dst,
+             str.length(), toUpper);
+   }
 }
 
-std::string toLowerCase(const std::string& str) {
-    std::string str2 = str;
-    toLowerCaseInPlace(str2);
+std::string toLowerCase(std::string_view str) {
+    WCLIB_INSTRUMENT_SCOPE("toLowerCase");
+    std::string str2(str.length(), '\0');
+    convertCase(str, &str2[0], false);
     return str2;
 }
 
+#if defined(__cpp_lib_memory_resource)
+std::pmr::string toLowerCase(std::string_view str,
+                             std::pmr::memory_resource *resource) {
+    WCLIB_INSTRUMENT_SCOPE("toLowerCase");
+    std::pmr::string str2(str.length(), '\0', resource);
+    convertCase(str, &str2[0], false);
+    return str2;
+}
+#endif
+
+void toLowerCase(std::string_view str, char *dst) {
+    WCLIB_INSTRUMENT_SCOPE("toLowerCase");
+    convertCase(str, dst, false);
+}
+
 void toLowerCaseInPlace(std::string& str) {
-    int nChars = str.length();
-    for (int i = 0; i < nChars; i++) {
-        str[i] = tolower(str[i]);
-    }
+    WCLIB_INSTRUMENT_SCOPE("toLowerCaseInPlace");
+    convertCase(str, &str[0], false);
 }
 
 char toUpperCase(char ch) {
-    return (char) toupper(ch);
+    return (char) toupper((unsigned char) ch);
+}
+
+std::string toUpperCase(std::string_view str) {
+    WCLIB_INSTRUMENT_SCOPE("toUpperCase");
+    std::string str2(str.length(), '\0');
+    convertCase(str, &str2[0], true);
+    return str2;
 }
 
-std::string toUpperCase(const std::string& str) {
-    std::string str2 = str;
-    toUpperCaseInPlace(str2);
+#if defined(__cpp_lib_memory_resource)
+std::pmr::string toUpperCase(std::string_view str,
+                             std::pmr::memory_resource *resource) {
+    WCLIB_INSTRUMENT_SCOPE("toUpperCase");
+    std::pmr::string str2(str.length(), '\0', resource);
+    convertCase(str, &str2[0], true);
     return str2;
 }
+#endif
+
+void toUpperCase(std::string_view str, char *dst) {
+    WCLIB_INSTRUMENT_SCOPE("toUpperCase");
+    convertCase(str, dst, true);
+}
 
 void toUpperCaseInPlace(std::string& str) {
-    int nChars = str.length();
-    for (int i = 0; i < nChars; i++) {
-        str[i] = toupper(str[i]);
+    WCLIB_INSTRUMENT_SCOPE("toUpperCaseInPlace");
+    convertCase(str, &str[0], true);
+}
+
+/*
+ * Implementation notes: UTF-8 case mapping
+ * ----------------------------------------
+ * Runs of ASCII text are found sixteen bytes at a time and converted
+ * by the block kernel above.  Every other code point is decoded and
+ * looked up in tables generated from the Unicode 14.0 character
+ * database.  Most mappings come in runs of consecutive code points, or
+ * of every second code point, that all move by the same distance, so
+ * each table stores one CaseRun per run and is searched by binary
+ * search.  The few mappings that produce more than one code point,
+ * such as U+00DF (ß) to "SS", are kept in separate tables of
+ * expansions, already encoded as UTF-8.  The titlecase tables only
+ * hold the code points whose titlecase differs from their uppercase.
+ * The cased and case-ignorable code points, which decide where a
+ * capital sigma is final, are stored as sorted ranges.
+ */
+
+namespace {
+   struct CaseRun {
+      uint32_t first;     /* First code point of the run            */
+      uint16_t count;     /* Number of code points in the run       */
+      uint8_t stride;     /* Distance between them, 1 or 2          */
+      int32_t delta;      /* Amount added to each one               */
+   };
+
+   struct CaseExpansion {
+      uint32_t codePoint;
+      const char *utf8;
+   };
+
+   struct CodePointRange {
+      uint32_t first;
+      uint32_t last;
+   };
+
+   constexpr CaseRun LOWER_RUNS[] = {
+      { 0x00C0, 23, 1, 32 }, { 0x00D8, 7, 1, 32 }, { 0x0100, 24, 2, 1 },
+      { 0x0132, 3, 2, 1 }, { 0x0139, 8, 2, 1 }, { 0x014A, 23, 2, 1 },
+      { 0x0178, 1, 1, -121 }, { 0x0179, 3, 2, 1 }, { 0x0181, 1, 1, 210 },
+      { 0x0182, 2, 2, 1 }, { 0x0186, 1, 1, 206 }, { 0x0187, 1, 1, 1 },
+      { 0x0189, 2, 1, 205 }, { 0x018B, 1, 1, 1 }, { 0x018E, 1, 1, 79 },
+      { 0x018F, 1, 1, 202 }, { 0x0190, 1, 1, 203 }, { 0x0191, 1, 1, 1 },
+      { 0x0193, 1, 1, 205 }, { 0x0194, 1, 1, 207 }, { 0x0196, 1, 1, 211 },
+      { 0x0197, 1, 1, 209 }, { 0x0198, 1, 1, 1 }, { 0x019C, 1, 1, 211 },
+      { 0x019D, 1, 1, 213 }, { 0x019F, 1, 1, 214 }, { 0x01A0, 3, 2, 1 },
+      { 0x01A6, 1, 1, 218 }, { 0x01A7, 1, 1, 1 }, { 0x01A9, 1, 1, 218 },
+      { 0x01AC, 1, 1, 1 }, { 0x01AE, 1, 1, 218 }, { 0x01AF, 1, 1, 1 },
+      { 0x01B1, 2, 1, 217 }, { 0x01B3, 2, 2, 1 }, { 0x01B7, 1, 1, 219 },
+      { 0x01B8, 1, 1, 1 }, { 0x01BC, 1, 1, 1 }, { 0x01C4, 1, 1, 2 },
+      { 0x01C5, 1, 1, 1 }, { 0x01C7, 1, 1, 2 }, { 0x01C8, 1, 1, 1 },
+      { 0x01CA, 1, 1, 2 }, { 0x01CB, 9, 2, 1 }, { 0x01DE, 9, 2, 1 },
+      { 0x01F1, 1, 1, 2 }, { 0x01F2, 2, 2, 1 }, { 0x01F6, 1, 1, -97 },
+      { 0x01F7, 1, 1, -56 }, { 0x01F8, 20, 2, 1 }, { 0x0220, 1, 1, -130 },
+      { 0x0222, 9, 2, 1 }, { 0x023A, 1, 1, 10795 }, { 0x023B, 1, 1, 1 },
+      { 0x023D, 1, 1, -163 }, { 0x023E, 1, 1, 10792 }, { 0x0241, 1, 1, 1 },
+      { 0x0243, 1, 1, -195 }, { 0x0244, 1, 1, 69 }, { 0x0245, 1, 1, 71 },
+      { 0x0246, 5, 2, 1 }, { 0x0370, 2, 2, 1 }, { 0x0376, 1, 1, 1 },
+      { 0x037F, 1, 1, 116 }, { 0x0386, 1, 1, 38 }, { 0x0388, 3, 1, 37 },
+      { 0x038C, 1, 1, 64 }, { 0x038E, 2, 1, 63 }, { 0x0391, 17, 1, 32 },
+      { 0x03A3, 9, 1, 32 }, { 0x03CF, 1, 1, 8 }, { 0x03D8, 12, 2, 1 },
+      { 0x03F4, 1, 1, -60 }, { 0x03F7, 1, 1, 1 }, { 0x03F9, 1, 1, -7 },
+      { 0x03FA, 1, 1, 1 }, { 0x03FD, 3, 1, -130 }, { 0x0400, 16, 1, 80 },
+      { 0x0410, 32, 1, 32 }, { 0x0460, 17, 2, 1 }, { 0x048A, 27, 2, 1 },
+      { 0x04C0, 1, 1, 15 }, { 0x04C1, 7, 2, 1 }, { 0x04D0, 48, 2, 1 },
+      { 0x0531, 38, 1, 48 }, { 0x10A0, 38, 1, 7264 }, { 0x10C7, 1, 1, 7264 },
+      { 0x10CD, 1, 1, 7264 }, { 0x13A0, 80, 1, 38864 }, { 0x13F0, 6, 1, 8 },
+      { 0x1C90, 43, 1, -3008 }, { 0x1CBD, 3, 1, -3008 }, { 0x1E00, 75, 2, 1 },
+      { 0x1E9E, 1, 1, -7615 }, { 0x1EA0, 48, 2, 1 }, { 0x1F08, 8, 1, -8 },
+      { 0x1F18, 6, 1, -8 }, { 0x1F28, 8, 1, -8 }, { 0x1F38, 8, 1, -8 },
+      { 0x1F48, 6, 1, -8 }, { 0x1F59, 4, 2, -8 }, { 0x1F68, 8, 1, -8 },
+      { 0x1F88, 8, 1, -8 }, { 0x1F98, 8, 1, -8 }, { 0x1FA8, 8, 1, -8 },
+      { 0x1FB8, 2, 1, -8 }, { 0x1FBA, 2, 1, -74 }, { 0x1FBC, 1, 1, -9 },
+      { 0x1FC8, 4, 1, -86 }, { 0x1FCC, 1, 1, -9 }, { 0x1FD8, 2, 1, -8 },
+      { 0x1FDA, 2, 1, -100 }, { 0x1FE8, 2, 1, -8 }, { 0x1FEA, 2, 1, -112 },
+      { 0x1FEC, 1, 1, -7 }, { 0x1FF8, 2, 1, -128 }, { 0x1FFA, 2, 1, -126 },
+      { 0x1FFC, 1, 1, -9 }, { 0x2126, 1, 1, -7517 }, { 0x212A, 1, 1, -8383 },
+      { 0x212B, 1, 1, -8262 }, { 0x2132, 1, 1, 28 }, { 0x2160, 16, 1, 16 },
+      { 0x2183, 1, 1, 1 }, { 0x24B6, 26, 1, 26 }, { 0x2C00, 48, 1, 48 },
+      { 0x2C60, 1, 1, 1 }, { 0x2C62, 1, 1, -10743 }, { 0x2C63, 1, 1, -3814 },
+      { 0x2C64, 1, 1, -10727 }, { 0x2C67, 3, 2, 1 }, { 0x2C6D, 1, 1, -10780 },
+      { 0x2C6E, 1, 1, -10749 }, { 0x2C6F, 1, 1, -10783 },
+      { 0x2C70, 1, 1, -10782 }, { 0x2C72, 1, 1, 1 }, { 0x2C75, 1, 1, 1 },
+      { 0x2C7E, 2, 1, -10815 }, { 0x2C80, 50, 2, 1 }, { 0x2CEB, 2, 2, 1 },
+      { 0x2CF2, 1, 1, 1 }, { 0xA640, 23, 2, 1 }, { 0xA680, 14, 2, 1 },
+      { 0xA722, 7, 2, 1 }, { 0xA732, 31, 2, 1 }, { 0xA779, 2, 2, 1 },
+      { 0xA77D, 1, 1, -35332 }, { 0xA77E, 5, 2, 1 }, { 0xA78B, 1, 1, 1 },
+      { 0xA78D, 1, 1, -42280 }, { 0xA790, 2, 2, 1 }, { 0xA796, 10, 2, 1 },
+      { 0xA7AA, 1, 1, -42308 }, { 0xA7AB, 1, 1, -42319 },
+      { 0xA7AC, 1, 1, -42315 }, { 0xA7AD, 1, 1, -42305 },
+      { 0xA7AE, 1, 1, -42308 }, { 0xA7B0, 1, 1, -42258 },
+      { 0xA7B1, 1, 1, -42282 }, { 0xA7B2, 1, 1, -42261 },
+      { 0xA7B3, 1, 1, 928 }, { 0xA7B4, 8, 2, 1 }, { 0xA7C4, 1, 1, -48 },
+      { 0xA7C5, 1, 1, -42307 }, { 0xA7C6, 1, 1, -35384 }, { 0xA7C7, 2, 2, 1 },
+      { 0xA7D0, 1, 1, 1 }, { 0xA7D6, 2, 2, 1 }, { 0xA7F5, 1, 1, 1 },
+      { 0xFF21, 26, 1, 32 }, { 0x10400, 40, 1, 40 }, { 0x104B0, 36, 1, 40 },
+      { 0x10570, 11, 1, 39 }, { 0x1057C, 15, 1, 39 }, { 0x1058C, 7, 1, 39 },
+      { 0x10594, 2, 1, 39 }, { 0x10C80, 51, 1, 64 },
+      { 0x118A0, 32, 1, 32 }, { 0x16E40, 32, 1, 32 }, { 0x1E900, 34, 1, 34 },
+   };
+
+   const CaseExpansion LOWER_EXPANSIONS[] = {
+      { 0x0130, "\x69\xCC\x87" },
+   };
+
+   constexpr CaseRun UPPER_RUNS[] = {
+      { 0x00B5, 1, 1, 743 }, { 0x00E0, 23, 1, -32 }, { 0x00F8, 7, 1, -32 },
+      { 0x00FF, 1, 1, 121 }, { 0x0101, 24, 2, -1 }, { 0x0131, 1, 1, -232 },
+      { 0x0133, 3, 2, -1 }, { 0x013A, 8, 2, -1 }, { 0x014B, 23, 2, -1 },
+      { 0x017A, 3, 2, -1 }, { 0x017F, 1, 1, -300 }, { 0x0180, 1, 1, 195 },
+      { 0x0183, 2, 2, -1 }, { 0x0188, 1, 1, -1 }, { 0x018C, 1, 1, -1 },
+      { 0x0192, 1, 1, -1 }, { 0x0195, 1, 1, 97 }, { 0x0199, 1, 1, -1 },
+      { 0x019A, 1, 1, 163 }, { 0x019E, 1, 1, 130 }, { 0x01A1, 3, 2, -1 },
+      { 0x01A8, 1, 1, -1 }, { 0x01AD, 1, 1, -1 }, { 0x01B0, 1, 1, -1 },
+      { 0x01B4, 2, 2, -1 }, { 0x01B9, 1, 1, -1 }, { 0x01BD, 1, 1, -1 },
+      { 0x01BF, 1, 1, 56 }, { 0x01C5, 1, 1, -1 }, { 0x01C6, 1, 1, -2 },
+      { 0x01C8, 1, 1, -1 }, { 0x01C9, 1, 1, -2 }, { 0x01CB, 1, 1, -1 },
+      { 0x01CC, 1, 1, -2 }, { 0x01CE, 8, 2, -1 }, { 0x01DD, 1, 1, -79 },
+      { 0x01DF, 9, 2, -1 }, { 0x01F2, 1, 1, -1 }, { 0x01F3, 1, 1, -2 },
+      { 0x01F5, 1, 1, -1 }, { 0x01F9, 20, 2, -1 }, { 0x0223, 9, 2, -1 },
+      { 0x023C, 1, 1, -1 }, { 0x023F, 2, 1, 10815 }, { 0x0242, 1, 1, -1 },
+      { 0x0247, 5, 2, -1 }, { 0x0250, 1, 1, 10783 }, { 0x0251, 1, 1, 10780 },
+      { 0x0252, 1, 1, 10782 }, { 0x0253, 1, 1, -210 }, { 0x0254, 1, 1, -206 },
+      { 0x0256, 2, 1, -205 }, { 0x0259, 1, 1, -202 }, { 0x025B, 1, 1, -203 },
+      { 0x025C, 1, 1, 42319 }, { 0x0260, 1, 1, -205 }, { 0x0261, 1, 1, 42315 },
+      { 0x0263, 1, 1, -207 }, { 0x0265, 1, 1, 42280 }, { 0x0266, 1, 1, 42308 },
+      { 0x0268, 1, 1, -209 }, { 0x0269, 1, 1, -211 }, { 0x026A, 1, 1, 42308 },
+      { 0x026B, 1, 1, 10743 }, { 0x026C, 1, 1, 42305 }, { 0x026F, 1, 1, -211 },
+      { 0x0271, 1, 1, 10749 }, { 0x0272, 1, 1, -213 }, { 0x0275, 1, 1, -214 },
+      { 0x027D, 1, 1, 10727 }, { 0x0280, 1, 1, -218 }, { 0x0282, 1, 1, 42307 },
+      { 0x0283, 1, 1, -218 }, { 0x0287, 1, 1, 42282 }, { 0x0288, 1, 1, -218 },
+      { 0x0289, 1, 1, -69 }, { 0x028A, 2, 1, -217 }, { 0x028C, 1, 1, -71 },
+      { 0x0292, 1, 1, -219 }, { 0x029D, 1, 1, 42261 }, { 0x029E, 1, 1, 42258 },
+      { 0x0345, 1, 1, 84 }, { 0x0371, 2, 2, -1 }, { 0x0377, 1, 1, -1 },
+      { 0x037B, 3, 1, 130 }, { 0x03AC, 1, 1, -38 }, { 0x03AD, 3, 1, -37 },
+      { 0x03B1, 17, 1, -32 }, { 0x03C2, 1, 1, -31 }, { 0x03C3, 9, 1, -32 },
+      { 0x03CC, 1, 1, -64 }, { 0x03CD, 2, 1, -63 }, { 0x03D0, 1, 1, -62 },
+      { 0x03D1, 1, 1, -57 }, { 0x03D5, 1, 1, -47 }, { 0x03D6, 1, 1, -54 },
+      { 0x03D7, 1, 1, -8 }, { 0x03D9, 12, 2, -1 }, { 0x03F0, 1, 1, -86 },
+      { 0x03F1, 1, 1, -80 }, { 0x03F2, 1, 1, 7 }, { 0x03F3, 1, 1, -116 },
+      { 0x03F5, 1, 1, -96 }, { 0x03F8, 1, 1, -1 }, { 0x03FB, 1, 1, -1 },
+      { 0x0430, 32, 1, -32 }, { 0x0450, 16, 1, -80 }, { 0x0461, 17, 2, -1 },
+      { 0x048B, 27, 2, -1 }, { 0x04C2, 7, 2, -1 }, { 0x04CF, 1, 1, -15 },
+      { 0x04D1, 48, 2, -1 }, { 0x0561, 38, 1, -48 }, { 0x10D0, 43, 1, 3008 },
+      { 0x10FD, 3, 1, 3008 }, { 0x13F8, 6, 1, -8 }, { 0x1C80, 1, 1, -6254 },
+      { 0x1C81, 1, 1, -6253 }, { 0x1C82, 1, 1, -6244 },
+      { 0x1C83, 2, 1, -6242 }, { 0x1C85, 1, 1, -6243 },
+      { 0x1C86, 1, 1, -6236 }, { 0x1C87, 1, 1, -6181 },
+      { 0x1C88, 1, 1, 35266 }, { 0x1D79, 1, 1, 35332 }, { 0x1D7D, 1, 1, 3814 },
+      { 0x1D8E, 1, 1, 35384 }, { 0x1E01, 75, 2, -1 }, { 0x1E9B, 1, 1, -59 },
+      { 0x1EA1, 48, 2, -1 }, { 0x1F00, 8, 1, 8 }, { 0x1F10, 6, 1, 8 },
+      { 0x1F20, 8, 1, 8 }, { 0x1F30, 8, 1, 8 }, { 0x1F40, 6, 1, 8 },
+      { 0x1F51, 4, 2, 8 }, { 0x1F60, 8, 1, 8 }, { 0x1F70, 2, 1, 74 },
+      { 0x1F72, 4, 1, 86 }, { 0x1F76, 2, 1, 100 }, { 0x1F78, 2, 1, 128 },
+      { 0x1F7A, 2, 1, 112 }, { 0x1F7C, 2, 1, 126 }, { 0x1FB0, 2, 1, 8 },
+      { 0x1FBE, 1, 1, -7205 }, { 0x1FD0, 2, 1, 8 }, { 0x1FE0, 2, 1, 8 },
+      { 0x1FE5, 1, 1, 7 }, { 0x214E, 1, 1, -28 }, { 0x2170, 16, 1, -16 },
+      { 0x2184, 1, 1, -1 }, { 0x24D0, 26, 1, -26 }, { 0x2C30, 48, 1, -48 },
+      { 0x2C61, 1, 1, -1 }, { 0x2C65, 1, 1, -10795 }, { 0x2C66, 1, 1, -10792 },
+      { 0x2C68, 3, 2, -1 }, { 0x2C73, 1, 1, -1 }, { 0x2C76, 1, 1, -1 },
+      { 0x2C81, 50, 2, -1 }, { 0x2CEC, 2, 2, -1 }, { 0x2CF3, 1, 1, -1 },
+      { 0x2D00, 38, 1, -7264 }, { 0x2D27, 1, 1, -7264 },
+      { 0x2D2D, 1, 1, -7264 }, { 0xA641, 23, 2, -1 }, { 0xA681, 14, 2, -1 },
+      { 0xA723, 7, 2, -1 }, { 0xA733, 31, 2, -1 }, { 0xA77A, 2, 2, -1 },
+      { 0xA77F, 5, 2, -1 }, { 0xA78C, 1, 1, -1 }, { 0xA791, 2, 2, -1 },
+      { 0xA794, 1, 1, 48 }, { 0xA797, 10, 2, -1 }, { 0xA7B5, 8, 2, -1 },
+      { 0xA7C8, 2, 2, -1 }, { 0xA7D1, 1, 1, -1 }, { 0xA7D7, 2, 2, -1 },
+      { 0xA7F6, 1, 1, -1 }, { 0xAB53, 1, 1, -928 }, { 0xAB70, 80, 1, -38864 },
+      { 0xFF41, 26, 1, -32 }, { 0x10428, 40, 1, -40 }, { 0x104D8, 36, 1, -40 },
+      { 0x10597, 11, 1, -39 }, { 0x105A3, 15, 1, -39 }, { 0x105B3, 7, 1, -39 },
+      { 0x105BB, 2, 1, -39 }, { 0x10CC0, 51, 1, -64 },
+      { 0x118C0, 32, 1, -32 }, { 0x16E60, 32, 1, -32 },
+      { 0x1E922, 34, 1, -34 },
+   };
+
+   const CaseExpansion UPPER_EXPANSIONS[] = {
+      { 0x00DF, "\x53\x53" }, { 0x0149, "\xCA\xBC\x4E" },
+      { 0x01F0, "\x4A\xCC\x8C" }, { 0x0390, "\xCE\x99\xCC\x88\xCC\x81" },
+      { 0x03B0, "\xCE\xA5\xCC\x88\xCC\x81" }, { 0x0587, "\xD4\xB5\xD5\x92" },
+      { 0x1E96, "\x48\xCC\xB1" }, { 0x1E97, "\x54\xCC\x88" },
+      { 0x1E98, "\x57\xCC\x8A" }, { 0x1E99, "\x59\xCC\x8A" },
+      { 0x1E9A, "\x41\xCA\xBE" }, { 0x1F50, "\xCE\xA5\xCC\x93" },
+      { 0x1F52, "\xCE\xA5\xCC\x93\xCC\x80" },
+      { 0x1F54, "\xCE\xA5\xCC\x93\xCC\x81" },
+      { 0x1F56, "\xCE\xA5\xCC\x93\xCD\x82" },
+      { 0x1F80, "\xE1\xBC\x88\xCE\x99" }, { 0x1F81, "\xE1\xBC\x89\xCE\x99" },
+      { 0x1F82, "\xE1\xBC\x8A\xCE\x99" }, { 0x1F83, "\xE1\xBC\x8B\xCE\x99" },
+      { 0x1F84, "\xE1\xBC\x8C\xCE\x99" }, { 0x1F85, "\xE1\xBC\x8D\xCE\x99" },
+      { 0x1F86, "\xE1\xBC\x8E\xCE\x99" }, { 0x1F87, "\xE1\xBC\x8F\xCE\x99" },
+      { 0x1F88, "\xE1\xBC\x88\xCE\x99" }, { 0x1F89, "\xE1\xBC\x89\xCE\x99" },
+      { 0x1F8A, "\xE1\xBC\x8A\xCE\x99" }, { 0x1F8B, "\xE1\xBC\x8B\xCE\x99" },
+      { 0x1F8C, "\xE1\xBC\x8C\xCE\x99" }, { 0x1F8D, "\xE1\xBC\x8D\xCE\x99" },
+      { 0x1F8E, "\xE1\xBC\x8E\xCE\x99" }, { 0x1F8F, "\xE1\xBC\x8F\xCE\x99" },
+      { 0x1F90, "\xE1\xBC\xA8\xCE\x99" }, { 0x1F91, "\xE1\xBC\xA9\xCE\x99" },
+      { 0x1F92, "\xE1\xBC\xAA\xCE\x99" }, { 0x1F93, "\xE1\xBC\xAB\xCE\x99" },
+      { 0x1F94, "\xE1\xBC\xAC\xCE\x99" }, { 0x1F95, "\xE1\xBC\xAD\xCE\x99" },
+      { 0x1F96, "\xE1\xBC\xAE\xCE\x99" }, { 0x1F97, "\xE1\xBC\xAF\xCE\x99" },
+      { 0x1F98, "\xE1\xBC\xA8\xCE\x99" }, { 0x1F99, "\xE1\xBC\xA9\xCE\x99" },
+      { 0x1F9A, "\xE1\xBC\xAA\xCE\x99" }, { 0x1F9B, "\xE1\xBC\xAB\xCE\x99" },
+      { 0x1F9C, "\xE1\xBC\xAC\xCE\x99" }, { 0x1F9D, "\xE1\xBC\xAD\xCE\x99" },
+      { 0x1F9E, "\xE1\xBC\xAE\xCE\x99" }, { 0x1F9F, "\xE1\xBC\xAF\xCE\x99" },
+      { 0x1FA0, "\xE1\xBD\xA8\xCE\x99" }, { 0x1FA1, "\xE1\xBD\xA9\xCE\x99" },
+      { 0x1FA2, "\xE1\xBD\xAA\xCE\x99" }, { 0x1FA3, "\xE1\xBD\xAB\xCE\x99" },
+      { 0x1FA4, "\xE1\xBD\xAC\xCE\x99" }, { 0x1FA5, "\xE1\xBD\xAD\xCE\x99" },
+      { 0x1FA6, "\xE1\xBD\xAE\xCE\x99" }, { 0x1FA7, "\xE1\xBD\xAF\xCE\x99" },
+      { 0x1FA8, "\xE1\xBD\xA8\xCE\x99" }, { 0x1FA9, "\xE1\xBD\xA9\xCE\x99" },
+      { 0x1FAA, "\xE1\xBD\xAA\xCE\x99" }, { 0x1FAB, "\xE1\xBD\xAB\xCE\x99" },
+      { 0x1FAC, "\xE1\xBD\xAC\xCE\x99" }, { 0x1FAD, "\xE1\xBD\xAD\xCE\x99" },
+      { 0x1FAE, "\xE1\xBD\xAE\xCE\x99" }, { 0x1FAF, "\xE1\xBD\xAF\xCE\x99" },
+      { 0x1FB2, "\xE1\xBE\xBA\xCE\x99" }, { 0x1FB3, "\xCE\x91\xCE\x99" },
+      { 0x1FB4, "\xCE\x86\xCE\x99" }, { 0x1FB6, "\xCE\x91\xCD\x82" },
+      { 0x1FB7, "\xCE\x91\xCD\x82\xCE\x99" }, { 0x1FBC, "\xCE\x91\xCE\x99" },
+      { 0x1FC2, "\xE1\xBF\x8A\xCE\x99" }, { 0x1FC3, "\xCE\x97\xCE\x99" },
+      { 0x1FC4, "\xCE\x89\xCE\x99" }, { 0x1FC6, "\xCE\x97\xCD\x82" },
+      { 0x1FC7, "\xCE\x97\xCD\x82\xCE\x99" }, { 0x1FCC, "\xCE\x97\xCE\x99" },
+      { 0x1FD2, "\xCE\x99\xCC\x88\xCC\x80" },
+      { 0x1FD3, "\xCE\x99\xCC\x88\xCC\x81" }, { 0x1FD6, "\xCE\x99\xCD\x82" },
+      { 0x1FD7, "\xCE\x99\xCC\x88\xCD\x82" },
+      { 0x1FE2, "\xCE\xA5\xCC\x88\xCC\x80" },
+      { 0x1FE3, "\xCE\xA5\xCC\x88\xCC\x81" }, { 0x1FE4, "\xCE\xA1\xCC\x93" },
+      { 0x1FE6, "\xCE\xA5\xCD\x82" }, { 0x1FE7, "\xCE\xA5\xCC\x88\xCD\x82" },
+      { 0x1FF2, "\xE1\xBF\xBA\xCE\x99" }, { 0x1FF3, "\xCE\xA9\xCE\x99" },
+      { 0x1FF4, "\xCE\x8F\xCE\x99" }, { 0x1FF6, "\xCE\xA9\xCD\x82" },
+      { 0x1FF7, "\xCE\xA9\xCD\x82\xCE\x99" }, { 0x1FFC, "\xCE\xA9\xCE\x99" },
+      { 0xFB00, "\x46\x46" }, { 0xFB01, "\x46\x49" }, { 0xFB02, "\x46\x4C" },
+      { 0xFB03, "\x46\x46\x49" }, { 0xFB04, "\x46\x46\x4C" },
+      { 0xFB05, "\x53\x54" }, { 0xFB06, "\x53\x54" },
+      { 0xFB13, "\xD5\x84\xD5\x86" }, { 0xFB14, "\xD5\x84\xD4\xB5" },
+      { 0xFB15, "\xD5\x84\xD4\xBB" }, { 0xFB16, "\xD5\x8E\xD5\x86" },
+      { 0xFB17, "\xD5\x84\xD4\xBD" },
+   };
+
+   constexpr CaseRun TITLE_RUNS[] = {
+      { 0x01C4, 1, 1, 1 }, { 0x01C5, 1, 1, 0 }, { 0x01C6, 1, 1, -1 },
+      { 0x01C7, 1, 1, 1 }, { 0x01C8, 1, 1, 0 }, { 0x01C9, 1, 1, -1 },
+      { 0x01CA, 1, 1, 1 }, { 0x01CB, 1, 1, 0 }, { 0x01CC, 1, 1, -1 },
+      { 0x01F1, 1, 1, 1 }, { 0x01F2, 1, 1, 0 }, { 0x01F3, 1, 1, -1 },
+      { 0x10D0, 43, 1, 0 }, { 0x10FD, 3, 1, 0 }, { 0x1F80, 8, 1, 8 },
+      { 0x1F88, 8, 1, 0 }, { 0x1F90, 8, 1, 8 }, { 0x1F98, 8, 1, 0 },
+      { 0x1FA0, 8, 1, 8 }, { 0x1FA8, 8, 1, 0 }, { 0x1FB3, 1, 1, 9 },
+      { 0x1FBC, 1, 1, 0 }, { 0x1FC3, 1, 1, 9 }, { 0x1FCC, 1, 1, 0 },
+      { 0x1FF3, 1, 1, 9 }, { 0x1FFC, 1, 1, 0 },
+   };
+
+   /*
+    * findCaseRun searches on the first code point of each run, so the
+    * runs in a table must be sorted and must not overlap, even where
+    * two stride-2 runs would interleave.
+    */
+   template <size_t N>
+   constexpr bool caseRunsAreDisjoint(const CaseRun (&runs)[N]) {
+      for (size_t i = 0; i < N; i++) {
+         if (runs[i].count == 0 || (runs[i].stride != 1 && runs[i].stride != 2)) return false;
+         if (i + 1 < N) {
+            uint32_t last = runs[i].first + uint32_t(runs[i].count - 1) * runs[i].stride;
+            if (last >= runs[i + 1].first) return false;
+         }
+      }
+      return true;
+   }
+
+   static_assert(caseRunsAreDisjoint(LOWER_RUNS), "LOWER_RUNS overlap");
+   static_assert(caseRunsAreDisjoint(UPPER_RUNS), "UPPER_RUNS overlap");
+   static_assert(caseRunsAreDisjoint(TITLE_RUNS), "TITLE_RUNS overlap");
+
+   const CaseExpansion TITLE_EXPANSIONS[] = {
+      { 0x00DF, "\x53\x73" }, { 0x0587, "\xD4\xB5\xD6\x82" },
+      { 0x1FB2, "\xE1\xBE\xBA\xCD\x85" }, { 0x1FB4, "\xCE\x86\xCD\x85" },
+      { 0x1FB7, "\xCE\x91\xCD\x82\xCD\x85" },
+      { 0x1FC2, "\xE1\xBF\x8A\xCD\x85" }, { 0x1FC4, "\xCE\x89\xCD\x85" },
+      { 0x1FC7, "\xCE\x97\xCD\x82\xCD\x85" },
+      { 0x1FF2, "\xE1\xBF\xBA\xCD\x85" }, { 0x1FF4, "\xCE\x8F\xCD\x85" },
+      { 0x1FF7, "\xCE\xA9\xCD\x82\xCD\x85" }, { 0xFB00, "\x46\x66" },
+      { 0xFB01, "\x46\x69" }, { 0xFB02, "\x46\x6C" },
+      { 0xFB03, "\x46\x66\x69" }, { 0xFB04, "\x46\x66\x6C" },
+      { 0xFB05, "\x53\x74" }, { 0xFB06, "\x53\x74" },
+      { 0xFB13, "\xD5\x84\xD5\xB6" }, { 0xFB14, "\xD5\x84\xD5\xA5" },
+      { 0xFB15, "\xD5\x84\xD5\xAB" }, { 0xFB16, "\xD5\x8E\xD5\xB6" },
+      { 0xFB17, "\xD5\x84\xD5\xAD" },
+   };
+
+   const CodePointRange CASED_RANGES[] = {
+      { 0x00AA, 0x00AA }, { 0x00B5, 0x00B5 }, { 0x00BA, 0x00BA },
+      { 0x00C0, 0x00D6 }, { 0x00D8, 0x00F6 }, { 0x00F8, 0x01BA },
+      { 0x01BC, 0x01BF }, { 0x01C4, 0x0293 }, { 0x0295, 0x02B8 },
+      { 0x02C0, 0x02C1 }, { 0x02E0, 0x02E4 }, { 0x0345, 0x0345 },
+      { 0x0370, 0x0373 }, { 0x0376, 0x0377 }, { 0x037A, 0x037D },
+      { 0x037F, 0x037F }, { 0x0386, 0x0386 }, { 0x0388, 0x038A },
+      { 0x038C, 0x038C }, { 0x038E, 0x03A1 }, { 0x03A3, 0x03F5 },
+      { 0x03F7, 0x0481 }, { 0x048A, 0x052F }, { 0x0531, 0x0556 },
+      { 0x0560, 0x0588 }, { 0x10A0, 0x10C5 }, { 0x10C7, 0x10C7 },
+      { 0x10CD, 0x10CD }, { 0x10D0, 0x10FA }, { 0x10FD, 0x10FF },
+      { 0x13A0, 0x13F5 }, { 0x13F8, 0x13FD }, { 0x1C80, 0x1C88 },
+      { 0x1C90, 0x1CBA }, { 0x1CBD, 0x1CBF }, { 0x1D00, 0x1DBF },
+      { 0x1E00, 0x1F15 }, { 0x1F18, 0x1F1D }, { 0x1F20, 0x1F45 },
+      { 0x1F48, 0x1F4D }, { 0x1F50, 0x1F57 }, { 0x1F59, 0x1F59 },
+      { 0x1F5B, 0x1F5B }, { 0x1F5D, 0x1F5D }, { 0x1F5F, 0x1F7D },
+      { 0x1F80, 0x1FB4 }, { 0x1FB6, 0x1FBC }, { 0x1FBE, 0x1FBE },
+      { 0x1FC2, 0x1FC4 }, { 0x1FC6, 0x1FCC }, { 0x1FD0, 0x1FD3 },
+      { 0x1FD6, 0x1FDB }, { 0x1FE0, 0x1FEC }, { 0x1FF2, 0x1FF4 },
+      { 0x1FF6, 0x1FFC }, { 0x2071, 0x2071 }, { 0x207F, 0x207F },
+      { 0x2090, 0x209C }, { 0x2102, 0x2102 }, { 0x2107, 0x2107 },
+      { 0x210A, 0x2113 }, { 0x2115, 0x2115 }, { 0x2119, 0x211D },
+      { 0x2124, 0x2124 }, { 0x2126, 0x2126 }, { 0x2128, 0x2128 },
+      { 0x212A, 0x212D }, { 0x212F, 0x2134 }, { 0x2139, 0x2139 },
+      { 0x213C, 0x213F }, { 0x2145, 0x2149 }, { 0x214E, 0x214E },
+      { 0x2160, 0x217F }, { 0x2183, 0x2184 }, { 0x24B6, 0x24E9 },
+      { 0x2C00, 0x2CE4 }, { 0x2CEB, 0x2CEE }, { 0x2CF2, 0x2CF3 },
+      { 0x2D00, 0x2D25 }, { 0x2D27, 0x2D27 }, { 0x2D2D, 0x2D2D },
+      { 0xA640, 0xA66D }, { 0xA680, 0xA69D }, { 0xA722, 0xA787 },
+      { 0xA78B, 0xA78E }, { 0xA790, 0xA7CA }, { 0xA7D0, 0xA7D1 },
+      { 0xA7D3, 0xA7D3 }, { 0xA7D5, 0xA7D9 }, { 0xA7F5, 0xA7F6 },
+      { 0xA7F8, 0xA7FA }, { 0xAB30, 0xAB5A }, { 0xAB5C, 0xAB68 },
+      { 0xAB70, 0xABBF }, { 0xFB00, 0xFB06 }, { 0xFB13, 0xFB17 },
+      { 0xFF21, 0xFF3A }, { 0xFF41, 0xFF5A }, { 0x10400, 0x1044F },
+      { 0x104B0, 0x104D3 }, { 0x104D8, 0x104FB }, { 0x10570, 0x1057A },
+      { 0x1057C, 0x1058A }, { 0x1058C, 0x10592 }, { 0x10594, 0x10595 },
+      { 0x10597, 0x105A1 }, { 0x105A3, 0x105B1 }, { 0x105B3, 0x105B9 },
+      { 0x105BB, 0x105BC }, { 0x10780, 0x10780 }, { 0x10783, 0x10785 },
+      { 0x10787, 0x107B0 }, { 0x107B2, 0x107BA }, { 0x10C80, 0x10CB2 },
+      { 0x10CC0, 0x10CF2 }, { 0x118A0, 0x118DF }, { 0x16E40, 0x16E7F },
+      { 0x1D400, 0x1D454 }, { 0x1D456, 0x1D49C }, { 0x1D49E, 0x1D49F },
+      { 0x1D4A2, 0x1D4A2 }, { 0x1D4A5, 0x1D4A6 }, { 0x1D4A9, 0x1D4AC },
+      { 0x1D4AE, 0x1D4B9 }, { 0x1D4BB, 0x1D4BB }, { 0x1D4BD, 0x1D4C3 },
+      { 0x1D4C5, 0x1D505 }, { 0x1D507, 0x1D50A }, { 0x1D50D, 0x1D514 },
+      { 0x1D516, 0x1D51C }, { 0x1D51E, 0x1D539 }, { 0x1D53B, 0x1D53E },
+      { 0x1D540, 0x1D544 }, { 0x1D546, 0x1D546 }, { 0x1D54A, 0x1D550 },
+      { 0x1D552, 0x1D6A5 }, { 0x1D6A8, 0x1D6C0 }, { 0x1D6C2, 0x1D6DA },
+      { 0x1D6DC, 0x1D6FA }, { 0x1D6FC, 0x1D714 }, { 0x1D716, 0x1D734 },
+      { 0x1D736, 0x1D74E }, { 0x1D750, 0x1D76E }, { 0x1D770, 0x1D788 },
+      { 0x1D78A, 0x1D7A8 }, { 0x1D7AA, 0x1D7C2 }, { 0x1D7C4, 0x1D7CB },
+      { 0x1DF00, 0x1DF09 }, { 0x1DF0B, 0x1DF1E }, { 0x1E900, 0x1E943 },
+      { 0x1F130, 0x1F149 }, { 0x1F150, 0x1F169 }, { 0x1F170, 0x1F189 },
+   };
+
+   const CodePointRange CASE_IGNORABLE_RANGES[] = {
+      { 0x0027, 0x0027 }, { 0x002E, 0x002E }, { 0x003A, 0x003A },
+      { 0x005E, 0x005E }, { 0x0060, 0x0060 }, { 0x00A8, 0x00A8 },
+      { 0x00AD, 0x00AD }, { 0x00AF, 0x00AF }, { 0x00B4, 0x00B4 },
+      { 0x00B7, 0x00B8 }, { 0x02B0, 0x036F }, { 0x0374, 0x0375 },
+      { 0x037A, 0x037A }, { 0x0384, 0x0385 }, { 0x0387, 0x0387 },
+      { 0x0483, 0x0489 }, { 0x0559, 0x0559 }, { 0x055F, 0x055F },
+      { 0x0591, 0x05BD }, { 0x05BF, 0x05BF }, { 0x05C1, 0x05C2 },
+      { 0x05C4, 0x05C5 }, { 0x05C7, 0x05C7 }, { 0x05F4, 0x05F4 },
+      { 0x0600, 0x0605 }, { 0x0610, 0x061A }, { 0x061C, 0x061C },
+      { 0x0640, 0x0640 }, { 0x064B, 0x065F }, { 0x0670, 0x0670 },
+      { 0x06D6, 0x06DD }, { 0x06DF, 0x06E8 }, { 0x06EA, 0x06ED },
+      { 0x070F, 0x070F }, { 0x0711, 0x0711 }, { 0x0730, 0x074A },
+      { 0x07A6, 0x07B0 }, { 0x07EB, 0x07F5 }, { 0x07FA, 0x07FA },
+      { 0x07FD, 0x07FD }, { 0x0816, 0x082D }, { 0x0859, 0x085B },
+      { 0x0888, 0x0888 }, { 0x0890, 0x0891 }, { 0x0898, 0x089F },
+      { 0x08C9, 0x0902 }, { 0x093A, 0x093A }, { 0x093C, 0x093C },
+      { 0x0941, 0x0948 }, { 0x094D, 0x094D }, { 0x0951, 0x0957 },
+      { 0x0962, 0x0963 }, { 0x0971, 0x0971 }, { 0x0981, 0x0981 },
+      { 0x09BC, 0x09BC }, { 0x09C1, 0x09C4 }, { 0x09CD, 0x09CD },
+      { 0x09E2, 0x09E3 }, { 0x09FE, 0x09FE }, { 0x0A01, 0x0A02 },
+      { 0x0A3C, 0x0A3C }, { 0x0A41, 0x0A42 }, { 0x0A47, 0x0A48 },
+      { 0x0A4B, 0x0A4D }, { 0x0A51, 0x0A51 }, { 0x0A70, 0x0A71 },
+      { 0x0A75, 0x0A75 }, { 0x0A81, 0x0A82 }, { 0x0ABC, 0x0ABC },
+      { 0x0AC1, 0x0AC5 }, { 0x0AC7, 0x0AC8 }, { 0x0ACD, 0x0ACD },
+      { 0x0AE2, 0x0AE3 }, { 0x0AFA, 0x0AFF }, { 0x0B01, 0x0B01 },
+      { 0x0B3C, 0x0B3C }, { 0x0B3F, 0x0B3F }, { 0x0B41, 0x0B44 },
+      { 0x0B4D, 0x0B4D }, { 0x0B55, 0x0B56 }, { 0x0B62, 0x0B63 },
+      { 0x0B82, 0x0B82 }, { 0x0BC0, 0x0BC0 }, { 0x0BCD, 0x0BCD },
+      { 0x0C00, 0x0C00 }, { 0x0C04, 0x0C04 }, { 0x0C3C, 0x0C3C },
+      { 0x0C3E, 0x0C40 }, { 0x0C46, 0x0C48 }, { 0x0C4A, 0x0C4D },
+      { 0x0C55, 0x0C56 }, { 0x0C62, 0x0C63 }, { 0x0C81, 0x0C81 },
+      { 0x0CBC, 0x0CBC }, { 0x0CBF, 0x0CBF }, { 0x0CC6, 0x0CC6 },
+      { 0x0CCC, 0x0CCD }, { 0x0CE2, 0x0CE3 }, { 0x0D00, 0x0D01 },
+      { 0x0D3B, 0x0D3C }, { 0x0D41, 0x0D44 }, { 0x0D4D, 0x0D4D },
+      { 0x0D62, 0x0D63 }, { 0x0D81, 0x0D81 }, { 0x0DCA, 0x0DCA },
+      { 0x0DD2, 0x0DD4 }, { 0x0DD6, 0x0DD6 }, { 0x0E31, 0x0E31 },
+      { 0x0E34, 0x0E3A }, { 0x0E46, 0x0E4E }, { 0x0EB1, 0x0EB1 },
+      { 0x0EB4, 0x0EBC }, { 0x0EC6, 0x0EC6 }, { 0x0EC8, 0x0ECD },
+      { 0x0F18, 0x0F19 }, { 0x0F35, 0x0F35 }, { 0x0F37, 0x0F37 },
+      { 0x0F39, 0x0F39 }, { 0x0F71, 0x0F7E }, { 0x0F80, 0x0F84 },
+      { 0x0F86, 0x0F87 }, { 0x0F8D, 0x0F97 }, { 0x0F99, 0x0FBC },
+      { 0x0FC6, 0x0FC6 }, { 0x102D, 0x1030 }, { 0x1032, 0x1037 },
+      { 0x1039, 0x103A }, { 0x103D, 0x103E }, { 0x1058, 0x1059 },
+      { 0x105E, 0x1060 }, { 0x1071, 0x1074 }, { 0x1082, 0x1082 },
+      { 0x1085, 0x1086 }, { 0x108D, 0x108D }, { 0x109D, 0x109D },
+      { 0x10FC, 0x10FC }, { 0x135D, 0x135F }, { 0x1712, 0x1714 },
+      { 0x1732, 0x1733 }, { 0x1752, 0x1753 }, { 0x1772, 0x1773 },
+      { 0x17B4, 0x17B5 }, { 0x17B7, 0x17BD }, { 0x17C6, 0x17C6 },
+      { 0x17C9, 0x17D3 }, { 0x17D7, 0x17D7 }, { 0x17DD, 0x17DD },
+      { 0x180B, 0x180F }, { 0x1843, 0x1843 }, { 0x1885, 0x1886 },
+      { 0x18A9, 0x18A9 }, { 0x1920, 0x1922 }, { 0x1927, 0x1928 },
+      { 0x1932, 0x1932 }, { 0x1939, 0x193B }, { 0x1A17, 0x1A18 },
+      { 0x1A1B, 0x1A1B }, { 0x1A56, 0x1A56 }, { 0x1A58, 0x1A5E },
+      { 0x1A60, 0x1A60 }, { 0x1A62, 0x1A62 }, { 0x1A65, 0x1A6C },
+      { 0x1A73, 0x1A7C }, { 0x1A7F, 0x1A7F }, { 0x1AA7, 0x1AA7 },
+      { 0x1AB0, 0x1ACE }, { 0x1B00, 0x1B03 }, { 0x1B34, 0x1B34 },
+      { 0x1B36, 0x1B3A }, { 0x1B3C, 0x1B3C }, { 0x1B42, 0x1B42 },
+      { 0x1B6B, 0x1B73 }, { 0x1B80, 0x1B81 }, { 0x1BA2, 0x1BA5 },
+      { 0x1BA8, 0x1BA9 }, { 0x1BAB, 0x1BAD }, { 0x1BE6, 0x1BE6 },
+      { 0x1BE8, 0x1BE9 }, { 0x1BED, 0x1BED }, { 0x1BEF, 0x1BF1 },
+      { 0x1C2C, 0x1C33 }, { 0x1C36, 0x1C37 }, { 0x1C78, 0x1C7D },
+      { 0x1CD0, 0x1CD2 }, { 0x1CD4, 0x1CE0 }, { 0x1CE2, 0x1CE8 },
+      { 0x1CED, 0x1CED }, { 0x1CF4, 0x1CF4 }, { 0x1CF8, 0x1CF9 },
+      { 0x1D2C, 0x1D6A }, { 0x1D78, 0x1D78 }, { 0x1D9B, 0x1DFF },
+      { 0x1FBD, 0x1FBD }, { 0x1FBF, 0x1FC1 }, { 0x1FCD, 0x1FCF },
+      { 0x1FDD, 0x1FDF }, { 0x1FED, 0x1FEF }, { 0x1FFD, 0x1FFE },
+      { 0x200B, 0x200F }, { 0x2018, 0x2019 }, { 0x2024, 0x2024 },
+      { 0x2027, 0x2027 }, { 0x202A, 0x202E }, { 0x2060, 0x2064 },
+      { 0x2066, 0x206F }, { 0x2071, 0x2071 }, { 0x207F, 0x207F },
+      { 0x2090, 0x209C }, { 0x20D0, 0x20F0 }, { 0x2C7C, 0x2C7D },
+      { 0x2CEF, 0x2CF1 }, { 0x2D6F, 0x2D6F }, { 0x2D7F, 0x2D7F },
+      { 0x2DE0, 0x2DFF }, { 0x2E2F, 0x2E2F }, { 0x3005, 0x3005 },
+      { 0x302A, 0x302D }, { 0x3031, 0x3035 }, { 0x303B, 0x303B },
+      { 0x3099, 0x309E }, { 0x30FC, 0x30FE }, { 0xA015, 0xA015 },
+      { 0xA4F8, 0xA4FD }, { 0xA60C, 0xA60C }, { 0xA66F, 0xA672 },
+      { 0xA674, 0xA67D }, { 0xA67F, 0xA67F }, { 0xA69C, 0xA69F },
+      { 0xA6F0, 0xA6F1 }, { 0xA700, 0xA721 }, { 0xA770, 0xA770 },
+      { 0xA788, 0xA78A }, { 0xA7F2, 0xA7F4 }, { 0xA7F8, 0xA7F9 },
+      { 0xA802, 0xA802 }, { 0xA806, 0xA806 }, { 0xA80B, 0xA80B },
+      { 0xA825, 0xA826 }, { 0xA82C, 0xA82C }, { 0xA8C4, 0xA8C5 },
+      { 0xA8E0, 0xA8F1 }, { 0xA8FF, 0xA8FF }, { 0xA926, 0xA92D },
+      { 0xA947, 0xA951 }, { 0xA980, 0xA982 }, { 0xA9B3, 0xA9B3 },
+      { 0xA9B6, 0xA9B9 }, { 0xA9BC, 0xA9BD }, { 0xA9CF, 0xA9CF },
+      { 0xA9E5, 0xA9E6 }, { 0xAA29, 0xAA2E }, { 0xAA31, 0xAA32 },
+      { 0xAA35, 0xAA36 }, { 0xAA43, 0xAA43 }, { 0xAA4C, 0xAA4C },
+      { 0xAA70, 0xAA70 }, { 0xAA7C, 0xAA7C }, { 0xAAB0, 0xAAB0 },
+      { 0xAAB2, 0xAAB4 }, { 0xAAB7, 0xAAB8 }, { 0xAABE, 0xAABF },
+      { 0xAAC1, 0xAAC1 }, { 0xAADD, 0xAADD }, { 0xAAEC, 0xAAED },
+      { 0xAAF3, 0xAAF4 }, { 0xAAF6, 0xAAF6 }, { 0xAB5B, 0xAB5F },
+      { 0xAB69, 0xAB6B }, { 0xABE5, 0xABE5 }, { 0xABE8, 0xABE8 },
+      { 0xABED, 0xABED }, { 0xFB1E, 0xFB1E }, { 0xFBB2, 0xFBC2 },
+      { 0xFE00, 0xFE0F }, { 0xFE13, 0xFE13 }, { 0xFE20, 0xFE2F },
+      { 0xFE52, 0xFE52 }, { 0xFE55, 0xFE55 }, { 0xFEFF, 0xFEFF },
+      { 0xFF07, 0xFF07 }, { 0xFF0E, 0xFF0E }, { 0xFF1A, 0xFF1A },
+      { 0xFF3E, 0xFF3E }, { 0xFF40, 0xFF40 }, { 0xFF70, 0xFF70 },
+      { 0xFF9E, 0xFF9F }, { 0xFFE3, 0xFFE3 }, { 0xFFF9, 0xFFFB },
+      { 0x101FD, 0x101FD }, { 0x102E0, 0x102E0 }, { 0x10376, 0x1037A },
+      { 0x10780, 0x10785 }, { 0x10787, 0x107B0 }, { 0x107B2, 0x107BA },
+      { 0x10A01, 0x10A03 }, { 0x10A05, 0x10A06 }, { 0x10A0C, 0x10A0F },
+      { 0x10A38, 0x10A3A }, { 0x10A3F, 0x10A3F }, { 0x10AE5, 0x10AE6 },
+      { 0x10D24, 0x10D27 }, { 0x10EAB, 0x10EAC }, { 0x10F46, 0x10F50 },
+      { 0x10F82, 0x10F85 }, { 0x11001, 0x11001 }, { 0x11038, 0x11046 },
+      { 0x11070, 0x11070 }, { 0x11073, 0x11074 }, { 0x1107F, 0x11081 },
+      { 0x110B3, 0x110B6 }, { 0x110B9, 0x110BA }, { 0x110BD, 0x110BD },
+      { 0x110C2, 0x110C2 }, { 0x110CD, 0x110CD }, { 0x11100, 0x11102 },
+      { 0x11127, 0x1112B }, { 0x1112D, 0x11134 }, { 0x11173, 0x11173 },
+      { 0x11180, 0x11181 }, { 0x111B6, 0x111BE }, { 0x111C9, 0x111CC },
+      { 0x111CF, 0x111CF }, { 0x1122F, 0x11231 }, { 0x11234, 0x11234 },
+      { 0x11236, 0x11237 }, { 0x1123E, 0x1123E }, { 0x112DF, 0x112DF },
+      { 0x112E3, 0x112EA }, { 0x11300, 0x11301 }, { 0x1133B, 0x1133C },
+      { 0x11340, 0x11340 }, { 0x11366, 0x1136C }, { 0x11370, 0x11374 },
+      { 0x11438, 0x1143F }, { 0x11442, 0x11444 }, { 0x11446, 0x11446 },
+      { 0x1145E, 0x1145E }, { 0x114B3, 0x114B8 }, { 0x114BA, 0x114BA },
+      { 0x114BF, 0x114C0 }, { 0x114C2, 0x114C3 }, { 0x115B2, 0x115B5 },
+      { 0x115BC, 0x115BD }, { 0x115BF, 0x115C0 }, { 0x115DC, 0x115DD },
+      { 0x11633, 0x1163A }, { 0x1163D, 0x1163D }, { 0x1163F, 0x11640 },
+      { 0x116AB, 0x116AB }, { 0x116AD, 0x116AD }, { 0x116B0, 0x116B5 },
+      { 0x116B7, 0x116B7 }, { 0x1171D, 0x1171F }, { 0x11722, 0x11725 },
+      { 0x11727, 0x1172B }, { 0x1182F, 0x11837 }, { 0x11839, 0x1183A },
+      { 0x1193B, 0x1193C }, { 0x1193E, 0x1193E }, { 0x11943, 0x11943 },
+      { 0x119D4, 0x119D7 }, { 0x119DA, 0x119DB }, { 0x119E0, 0x119E0 },
+      { 0x11A01, 0x11A0A }, { 0x11A33, 0x11A38 }, { 0x11A3B, 0x11A3E },
+      { 0x11A47, 0x11A47 }, { 0x11A51, 0x11A56 }, { 0x11A59, 0x11A5B },
+      { 0x11A8A, 0x11A96 }, { 0x11A98, 0x11A99 }, { 0x11C30, 0x11C36 },
+      { 0x11C38, 0x11C3D }, { 0x11C3F, 0x11C3F }, { 0x11C92, 0x11CA7 },
+      { 0x11CAA, 0x11CB0 }, { 0x11CB2, 0x11CB3 }, { 0x11CB5, 0x11CB6 },
+      { 0x11D31, 0x11D36 }, { 0x11D3A, 0x11D3A }, { 0x11D3C, 0x11D3D },
+      { 0x11D3F, 0x11D45 }, { 0x11D47, 0x11D47 }, { 0x11D90, 0x11D91 },
+      { 0x11D95, 0x11D95 }, { 0x11D97, 0x11D97 }, { 0x11EF3, 0x11EF4 },
+      { 0x13430, 0x13438 }, { 0x16AF0, 0x16AF4 }, { 0x16B30, 0x16B36 },
+      { 0x16B40, 0x16B43 }, { 0x16F4F, 0x16F4F }, { 0x16F8F, 0x16F9F },
+      { 0x16FE0, 0x16FE1 }, { 0x16FE3, 0x16FE4 }, { 0x1AFF0, 0x1AFF3 },
+      { 0x1AFF5, 0x1AFFB }, { 0x1AFFD, 0x1AFFE }, { 0x1BC9D, 0x1BC9E },
+      { 0x1BCA0, 0x1BCA3 }, { 0x1CF00, 0x1CF2D }, { 0x1CF30, 0x1CF46 },
+      { 0x1D167, 0x1D169 }, { 0x1D173, 0x1D182 }, { 0x1D185, 0x1D18B },
+      { 0x1D1AA, 0x1D1AD }, { 0x1D242, 0x1D244 }, { 0x1DA00, 0x1DA36 },
+      { 0x1DA3B, 0x1DA6C }, { 0x1DA75, 0x1DA75 }, { 0x1DA84, 0x1DA84 },
+      { 0x1DA9B, 0x1DA9F }, { 0x1DAA1, 0x1DAAF }, { 0x1E000, 0x1E006 },
+      { 0x1E008, 0x1E018 }, { 0x1E01B, 0x1E021 }, { 0x1E023, 0x1E024 },
+      { 0x1E026, 0x1E02A }, { 0x1E130, 0x1E13D }, { 0x1E2AE, 0x1E2AE },
+      { 0x1E2EC, 0x1E2EF }, { 0x1E8D0, 0x1E8D6 }, { 0x1E944, 0x1E94B },
+      { 0x1F3FB, 0x1F3FF }, { 0xE0001, 0xE0001 }, { 0xE0020, 0xE007F },
+      { 0xE0100, 0xE01EF },
+   };
+
+   template <size_t N>
+   const CaseRun *findCaseRun(const CaseRun (&runs)[N], uint32_t cp) {
+      const CaseRun *run = std::upper_bound(runs, runs + N, cp,
+         [](uint32_t c, const CaseRun& r) { return c < r.first; });
+      if (run == runs) return NULL;
+      run--;
+      uint32_t offset = cp - run->first;
+      if (offset % run->stride != 0 || offset / run->stride >= run->count) return NULL;
+      return run;
+   }
+
+   template <size_t N>
+   const char *findExpansion(const CaseExpansion (&expansions)[N], uint32_t cp) {
+      const CaseExpansion *e = std::lower_bound(expansions, expansions + N, cp,
+         [](const CaseExpansion& x, uint32_t c) { return x.codePoint < c; });
+      return (e != expansions + N && e->codePoint == cp) ? e->utf8 : NULL;
+   }
+
+   enum CaseMapping { MAP_LOWER, MAP_UPPER, MAP_TITLE };
+
+   bool isAsciiLetter(uint32_t ch) {
+      return ((ch | 0x20) - 'a') < 26;
+   }
+
+   template <size_t N>
+   bool searchRanges(const CodePointRange (&ranges)[N], uint32_t cp) {
+      const CodePointRange *range = std::upper_bound(ranges, ranges + N, cp,
+         [](uint32_t c, const CodePointRange& r) { return c < r.first; });
+      return range != ranges && cp <= range[-1].last;
+   }
+
+   /*
+    * The code points of two-byte sequences, which cover the Latin,
+    * Greek and Cyrillic alphabets among others, are looked up directly
+    * in a table built from the runs on first use.
+    */
+   struct TwoByteCase {
+      uint32_t mapped[3];   /* Indexed by CaseMapping; 0 if it expands */
+      bool cased;
+      bool ignorable;
+   };
+
+   /* Returns the single code point cp maps to, or 0 if it expands */
+   uint32_t simpleMapping(uint32_t cp, CaseMapping mapping) {
+      const char *expansion = NULL;
+      const CaseRun *run = NULL;
+      if (mapping == MAP_TITLE) {
+         expansion = findExpansion(TITLE_EXPANSIONS, cp);
+         if (expansion == NULL) run = findCaseRun(TITLE_RUNS, cp);
+         if (expansion == NULL && run == NULL) mapping = MAP_UPPER;
+      }
+      if (mapping == MAP_UPPER) {
+         expansion = findExpansion(UPPER_EXPANSIONS, cp);
+         if (expansion == NULL) run = findCaseRun(UPPER_RUNS, cp);
+      } else if (mapping == MAP_LOWER) {
+         expansion = findExpansion(LOWER_EXPANSIONS, cp);
+         if (expansion == NULL) run = findCaseRun(LOWER_RUNS, cp);
+      }
+      if (expansion != NULL) return 0;
+      return (run == NULL) ? cp : uint32_t(cp + run->delta);
+   }
+
+   const TwoByteCase *twoByteCaseTable() {
+      static const std::vector<TwoByteCase> table = [] {
+         std::vector<TwoByteCase> cases(0x800);
+         for (uint32_t cp = 0x80; cp < 0x800; cp++) {
+            for (CaseMapping mapping : { MAP_LOWER, MAP_UPPER, MAP_TITLE }) {
+               cases[cp].mapped[mapping] = simpleMapping(cp, mapping);
+            }
+            cases[cp].cased = searchRanges(CASED_RANGES, cp);
+            cases[cp].ignorable = searchRanges(CASE_IGNORABLE_RANGES, cp);
+         }
+         return cases;
+      }();
+      return table.data();
+   }
+
+   bool isCasedCodePoint(uint32_t cp) {
+      if (cp < 0x80) return isAsciiLetter(cp);
+      if (cp < 0x800) return twoByteCaseTable()[cp].cased;
+      return searchRanges(CASED_RANGES, cp);
+   }
+
+   bool isCaseIgnorable(uint32_t cp) {
+      if (cp < 0x80) return cp == '\'' || cp == '.' || cp == ':' || cp == '^' || cp == '`';
+      if (cp < 0x800) return twoByteCaseTable()[cp].ignorable;
+      return searchRanges(CASE_IGNORABLE_RANGES, cp);
+   }
+
+   /* Returns the length of the sequence at p, or 0 if it is not valid */
+   int decodeUtf8(const unsigned char *p, size_t n, uint32_t& cp) {
+      unsigned char b = p[0];
+      int length;
+      uint32_t min;
+      if (b < 0x80) {
+         cp = b;
+         return 1;
+      } else if (b >= 0xC2 && b < 0xE0) {
+         length = 2; cp = b & 0x1F; min = 0x80;
+      } else if (b >= 0xE0 && b < 0xF0) {
+         length = 3; cp = b & 0x0F; min = 0x800;
+      } else if (b >= 0xF0 && b < 0xF5) {
+         length = 4; cp = b & 0x07; min = 0x10000;
+      } else {
+         return 0;
+      }
+      if (n < size_t(length)) return 0;
+      for (int i = 1; i < length; i++) {
+         if ((p[i] & 0xC0) != 0x80) return 0;
+         cp = (cp << 6) | (p[i] & 0x3F);
+      }
+      if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp < 0xE000)) return 0;
+      return length;
+   }
+
+   char *writeUtf8(char *dst, uint32_t cp) {
+      if (cp < 0x80) {
+         *dst++ = char(cp);
+      } else if (cp < 0x800) {
+         *dst++ = char(0xC0 | (cp >> 6));
+         *dst++ = char(0x80 | (cp & 0x3F));
+      } else if (cp < 0x10000) {
+         *dst++ = char(0xE0 | (cp >> 12));
+         *dst++ = char(0x80 | ((cp >> 6) & 0x3F));
+         *dst++ = char(0x80 | (cp & 0x3F));
+      } else {
+         *dst++ = char(0xF0 | (cp >> 18));
+         *dst++ = char(0x80 | ((cp >> 12) & 0x3F));
+         *dst++ = char(0x80 | ((cp >> 6) & 0x3F));
+         *dst++ = char(0x80 | (cp & 0x3F));
+      }
+      return dst;
+   }
+
+   /* The most bytes one code point can map to, as in U+0390 to U+0399 U+0308 U+0301 */
+   const size_t MAX_MAPPED_BYTES = 12;
+
+   char *writeMapped(char *dst, uint32_t cp, CaseMapping mapping) {
+      uint32_t mapped = (cp < 0x800) ? twoByteCaseTable()[cp].mapped[mapping]
+                                     : simpleMapping(cp, mapping);
+      if (mapped != 0) return writeUtf8(dst, mapped);
+      const char *expansion = NULL;
+      if (mapping == MAP_TITLE) expansion = findExpansion(TITLE_EXPANSIONS, cp);
+      if (expansion == NULL && mapping != MAP_LOWER) {
+         expansion = findExpansion(UPPER_EXPANSIONS, cp);
+      }
+      if (expansion == NULL) expansion = findExpansion(LOWER_EXPANSIONS, cp);
+      size_t length = strlen(expansion);
+      memcpy(dst, expansion, length);
+      return dst + length;
+   }
+
+   /* Returns the number of ASCII bytes at the beginning of p */
+   size_t asciiPrefixLength(const unsigned char *p, size_t n) {
+      size_t i = 0;
+#if defined(UTIL_CASE_X86) && defined(__SSE2__)
+      for (; i + 16 <= n; i += 16) {
+         int mask = _mm_movemask_epi8(_mm_loadu_si128((const __m128i *) (p + i)));
+         if (mask != 0) return i + __builtin_ctz(mask);
+      }
+#endif
+      for (; i + 8 <= n; i += 8) {
+         uint64_t word;
+         memcpy(&word, p + i, 8);
+         word &= 0x8080808080808080ULL;
+         if (word != 0) {
+#if defined(__GNUC__) && (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+            return i + __builtin_ctzll(word) / 8;
+#else
+            break;
+#endif
+         }
+      }
+      while (i < n && p[i] < 0x80) i++;
+      return i;
+   }
+
+   /*
+    * Returns true if a capital sigma before src[i] is not followed by a
+    * cased letter, once any case-ignorable code points are skipped.
+    */
+   bool sigmaIsFinal(const unsigned char *src, size_t n, size_t i) {
+      while (i < n) {
+         uint32_t cp;
+         int length = decodeUtf8(src + i, n - i, cp);
+         if (length == 0) return true;
+         if (!isCaseIgnorable(cp)) return !isCasedCodePoint(cp);
+         i += length;
+      }
+      return true;
+   }
+
+   bool isWordJoiner(uint32_t cp) {
+      return cp == '\'' || cp == 0x2019 || (cp >= 0x0300 && cp < 0x0370);
+   }
+
+   enum CaseStyle { STYLE_LOWER, STYLE_UPPER, STYLE_CAPITALIZE, STYLE_TITLE };
+
+   /*
+    * The result is written into a string that starts with room for the
+    * input and one mapping, and grows only when mappings make the text
+    * longer than its source.  Two-byte sequences, the common case
+    * outside ASCII, are decoded inline.
+    */
+   std::string convertCaseUtf8(std::string_view str, CaseStyle style) {
+      const unsigned char *src = (const unsigned char *) str.data();
+      size_t n = str.length();
+      const TwoByteCase *twoByteCases = twoByteCaseTable();
+      std::string out(n + MAX_MAPPED_BYTES, '\0');
+      size_t pos = 0;
+      bool afterCased = false; /* Last code point that is not case-ignorable is cased */
+      bool wordStart = true;   /* Next cased code point starts a word   */
+      size_t i = 0;
+      while (i < n) {
+         size_t run = (src[i] < 0x80) ? asciiPrefixLength(src + i, n - i) : 0;
+         if (run > 0) {
+            if (out.length() < pos + run) out.resize(std::max(2 * out.length(), pos + run));
+            char *dst = &out[pos];
+            if (style == STYLE_TITLE) {
+               for (size_t k = 0; k < run; k++) {
+                  unsigned char ch = src[i + k];
+                  if (isAsciiLetter(ch)) {
+                     dst[k] = wordStart ? (ch & ~0x20) : (ch | 0x20);
+                     wordStart = false;
+                  } else {
+                     dst[k] = ch;
+                     if (ch >= '0' && ch <= '9') {
+                        wordStart = false;
+                     } else if (ch != '\'') {
+                        wordStart = true;
+                     }
+                  }
+               }
+            } else {
+               convertCase(std::string_view(str.data() + i, run), dst, style == STYLE_UPPER);
+               if (style == STYLE_CAPITALIZE && i == 0 && isAsciiLetter(src[0])) {
+                  dst[0] = src[0] & ~0x20;
+               }
+            }
+            for (size_t k = run; k-- > 0; ) {
+               if (!isCaseIgnorable(src[i + k])) {
+                  afterCased = isAsciiLetter(src[i + k]);
+                  break;
+               }
+            }
+            pos += run;
+            i += run;
+            continue;
+         }
+         if (out.length() < pos + MAX_MAPPED_BYTES) {
+            out.resize(std::max(2 * out.length(), pos + MAX_MAPPED_BYTES));
+         }
+         uint32_t cp;
+         int length;
+         if (src[i] >= 0xC2 && src[i] < 0xE0 && i + 1 < n && (src[i + 1] & 0xC0) == 0x80) {
+            cp = ((src[i] & 0x1F) << 6) | (src[i + 1] & 0x3F);
+            length = 2;
+         } else {
+            length = decodeUtf8(src + i, n - i, cp);
+         }
+         if (length == 0) {
+            out[pos++] = char(src[i++]);
+            afterCased = false;
+            wordStart = true;
+            continue;
+         }
+         const TwoByteCase *entry = (cp < 0x800) ? &twoByteCases[cp] : NULL;
+         bool cased = entry ? entry->cased : isCasedCodePoint(cp);
+         CaseMapping mapping = MAP_LOWER;
+         if (style == STYLE_UPPER) {
+            mapping = MAP_UPPER;
+         } else if (style == STYLE_CAPITALIZE && i == 0) {
+            mapping = MAP_TITLE;
+         } else if (style == STYLE_TITLE && cased && wordStart) {
+            mapping = MAP_TITLE;
+         }
+         if (mapping == MAP_LOWER && cp == 0x03A3 && afterCased && sigmaIsFinal(src, n, i + length)) {
+            cp = 0x03C2;
+            entry = &twoByteCases[cp];
+         }
+         uint32_t mapped = entry ? entry->mapped[mapping] : 0;
+         if (mapped >= 0x80 && mapped < 0x800) {
+            out[pos++] = char(0xC0 | (mapped >> 6));
+            out[pos++] = char(0x80 | (mapped & 0x3F));
+         } else {
+            pos = writeMapped(&out[pos], cp, mapping) - &out[0];
+         }
+         if (cased || (cp >= '0' && cp <= '9')) {
+            wordStart = false;
+         } else if (!isWordJoiner(cp)) {
+            wordStart = true;
+         }
+         if (!(entry ? entry->ignorable : isCaseIgnorable(cp))) afterCased = cased;
+         i += length;
+      }
+      out.resize(pos);
+      return out;
+   }
+}
+
+std::string toLowerCaseUtf8(std::string_view str) {
+    WCLIB_INSTRUMENT_SCOPE("toLowerCaseUtf8");
+    return convertCaseUtf8(str, STYLE_LOWER);
+}
+
+std::string toUpperCaseUtf8(std::string_view str) {
+    WCLIB_INSTRUMENT_SCOPE("toUpperCaseUtf8");
+    return convertCaseUtf8(str, STYLE_UPPER);
+}
+
+std::string capitalizeUtf8(std::string_view str) {
+    WCLIB_INSTRUMENT_SCOPE("capitalizeUtf8");
+    return convertCaseUtf8(str, STYLE_CAPITALIZE);
+}
+
+std::string toTitleCaseUtf8(std::string_view str) {
+    WCLIB_INSTRUMENT_SCOPE("toTitleCaseUtf8");
+    return convertCaseUtf8(str, STYLE_TITLE);
+}
+
+std::string trim(std::string_view str) {
+    WCLIB_INSTRUMENT_SCOPE("trim");
+    return std::string(trimView(str));
+}
+
+#if defined(__cpp_lib_memory_resource)
+std::pmr::string trim(std::string_view str, std::pmr::memory_resource *resource) {
+    WCLIB_INSTRUMENT_SCOPE("trim");
+    return std::pmr::string(trimView(str), resource);
+}
+#endif
+
+std::string_view trimView(std::string_view str) {
+    return trimStartView(trimEndView(str));
+}
+
+void trimInPlace(std::string& str) {
+    WCLIB_INSTRUMENT_SCOPE("trimInPlace");
+    trimEndInPlace(str);
+    trimStartInPlace(str);
+}
+
+std::string trimEnd(std::string_view str) {
+    WCLIB_INSTRUMENT_SCOPE("trimEnd");
+    return std::string(trimEndView(str));
+}
+
+#if defined(__cpp_lib_memory_resource)
+std::pmr::string trimEnd(std::string_view str, std::pmr::memory_resource *resource) {
+    WCLIB_INSTRUMENT_SCOPE("trimEnd");
+    return std::pmr::string(trimEndView(str), resource);
+}
+#endif
+
+std::string_view trimEndView(std::string_view str) {
+    size_t finish = str.length();
+    while (finish > 0 && isspace((unsigned char) str[finish - 1])) {
+        finish--;
     }
+    return str.substr(0, finish);
 }
 
-std::string trim(const std::string& str) {
-    std::string str2 = str;
-    trimInPlace(str2);
-    return str2;
+void trimEndInPlace(std::string& str) {
+    WCLIB_INSTRUMENT_SCOPE("trimEndInPlace");
+    int end = (int)str.length();
+    int finish = (int)trimEndView(str).length();
+    if (finish < end) {
+        str.erase(finish, end - finish);
+    }
+}
+
+std::string trimStart(std::string_view str) {
+    WCLIB_INSTRUMENT_SCOPE("trimStart");
+    return std::string(trimStartView(str));
 }
 
-void trimInPlace(std::string& str) {
-    trimEndInPlace(str);
-    trimStartInPlace(str);
+#if defined(__cpp_lib_memory_resource)
+std::pmr::string trimStart(std::string_view str, std::pmr::memory_resource *resource) {
+    WCLIB_INSTRUMENT_SCOPE("trimStart");
+    return std::pmr::string(trimStartView(str), resource);
+}
+#endif
+
+std::string_view trimStartView(std::string_view str) {
+    size_t start = 0;
+    while (start < str.length() && isspace((unsigned char) str[start])) {
+        start++;
+    }
+    return str.substr(start);
+}
+
+void trimStartInPlace(std::string& str) {
+    WCLIB_INSTRUMENT_SCOPE("trimStartInPlace");
+    int start = (int)(str.length() - trimStartView(str).length());
+    if (start > 0) {
+        str.erase(0, start);
+    }
+}
+
+/* CharClass ------------------------------------------*/
+
+CharClass::CharClass() {
+   bits[0] = bits[1] = bits[2] = bits[3] = 0;
+}
+
+CharClass::CharClass(std::string_view chars) {
+   bits[0] = bits[1] = bits[2] = bits[3] = 0;
+   add(chars);
+}
+
+void CharClass::add(char ch) {
+   unsigned char uc = (unsigned char) ch;
+   bits[uc >> 6] |= uint64_t(1) << (uc & 63);
+}
+
+void CharClass::add(std::string_view chars) {
+   for (char ch : chars) {
+      add(ch);
+   }
+}
+
+bool CharClass::isEmpty() const {
+   return (bits[0] | bits[1] | bits[2] | bits[3]) == 0;
+}
+
+int CharClass::countIn(std::string_view str) const {
+   WCLIB_INSTRUMENT_SCOPE("CharClass::countIn");
+   int count = 0;
+   for (char ch : str) {
+      count += contains(ch);
+   }
+   return count;
+}
+
+/*
+ * Implementation notes: compact
+ * -----------------------------
+ * Every character is stored unconditionally and the output position
+ * advances only when the character is kept, so the loop has no
+ * data-dependent branch.  The source and destination may be the same
+ * buffer, since the write position never passes the read position.
+ */
+
+int CharClass::compact(char *dst, const char *src, int nChars) const {
+   int j = 0;
+   for (int i = 0; i < nChars; i++) {
+      char ch = src[i];
+      dst[j] = ch;
+      j += !contains(ch);
+   }
+   return j;
+}
+
+std::string CharClass::removeFrom(std::string_view str) const {
+   WCLIB_INSTRUMENT_SCOPE("CharClass::removeFrom");
+   std::string result(str.length(), '\0');
+   result.resize(compact(&result[0], str.data(), str.length()));
+   return result;
+}
+
+#if defined(__cpp_lib_memory_resource)
+std::pmr::string CharClass::removeFrom(std::string_view str,
+                                       std::pmr::memory_resource *resource) const {
+   WCLIB_INSTRUMENT_SCOPE("CharClass::removeFrom");
+   std::pmr::string result(str.length(), '\0', resource);
+   result.resize(compact(&result[0], str.data(), str.length()));
+   return result;
+}
+#endif
+
+int CharClass::removeFromInPlace(std::string& str) const {
+   WCLIB_INSTRUMENT_SCOPE("CharClass::removeFromInPlace");
+   int nChars = str.length();
+   int nKept = compact(&str[0], str.data(), nChars);
+   str.resize(nKept);
+   return nChars - nKept;
+}
+
+/* Number formatting ----------------------------------*/
+
+DigitGrouping::DigitGrouping(char separator, char decimalPoint,
+                             const std::string& grouping) {
+   this->separator = separator;
+   this->decimalPoint = decimalPoint;
+   this->grouping = grouping;
+}
+
+DigitGrouping::DigitGrouping(const std::locale& loc) {
+   const std::numpunct<char>& np = std::use_facet<std::numpunct<char> >(loc);
+   separator = np.thousands_sep();
+   decimalPoint = np.decimal_point();
+   grouping = np.grouping();
+}
+
+/*
+ * Implementation notes: digit grouping
+ * ------------------------------------
+ * A GroupCursor is stepped once per integer digit, starting from the
+ * rightmost digit, and reports whether a separator goes immediately
+ * before (to the left of) that digit.  The group sizes repeat the last
+ * entry, and a size that is zero, negative or CHAR_MAX ends grouping,
+ * as for std::numpunct.  The length computation and the writers step
+ * the same cursor, so they always agree on where the separators go.
+ */
+
+namespace {
+   struct GroupCursor {
+      std::string_view sizes;
+      size_t index;
+      int left;
+      bool active;
+
+      static bool isGroupSize(char size) {
+         return size > 0 && size != CHAR_MAX;
+      }
+
+      GroupCursor(std::string_view sizes) : sizes(sizes), index(0) {
+         active = !sizes.empty() && isGroupSize(sizes[0]);
+         left = active ? sizes[0] : 0;
+      }
+
+      bool separatorBeforeNextDigit() {
+         bool separator = false;
+         if (active && left == 0) {
+            separator = true;
+            if (index + 1 < sizes.length()) index++;
+            active = isGroupSize(sizes[index]);
+            left = sizes[index];
+         }
+         left--;
+         return separator;
+      }
+   };
+
+   int countDigits(uint64_t n) {
+      int nDigits = 1;
+      while (n >= 10) {
+         n /= 10;
+         nDigits++;
+      }
+      return nDigits;
+   }
+
+   int countSeparators(int nDigits, std::string_view sizes) {
+      GroupCursor cursor(sizes);
+      int nSeparators = 0;
+      for (int i = 0; i < nDigits; i++) {
+         nSeparators += cursor.separatorBeforeNextDigit();
+      }
+      return nSeparators;
+   }
+}
+
+int groupedIntegerLength(uint64_t magnitude, bool negative,
+                         const DigitGrouping& grouping) {
+   int nDigits = countDigits(magnitude);
+   return negative + nDigits + countSeparators(nDigits, grouping.grouping);
+}
+
+int writeGroupedInteger(char *dst, uint64_t magnitude, bool negative,
+                        const DigitGrouping& grouping) {
+   int length = groupedIntegerLength(magnitude, negative, grouping);
+   char *p = dst + length;
+   GroupCursor cursor(grouping.grouping);
+   do {
+      if (cursor.separatorBeforeNextDigit()) *--p = grouping.separator;
+      *--p = char('0' + magnitude % 10);
+      magnitude /= 10;
+   } while (magnitude != 0);
+   if (negative) *--p = '-';
+   return length;
+}
+
+/*
+ * Implementation notes: appendWithCommas
+ * --------------------------------------
+ * The output length is known as soon as the integer digits have been
+ * located, so the string is resized once and then filled in a single
+ * back-to-front pass: first the tail after the digits, then the digits
+ * and separators, then the sign.
+ */
+
+/*
+ * Implementation notes: appendGroupedNumber
+ * -----------------------------------------
+ * Shared by the std::string and std::pmr::string versions of
+ * appendWithCommas.  Since out is resized before number is read, a
+ * number that points into out itself is first copied, so calls such as
+ * appendWithCommas(s, s) do not read through a dangling view.
+ */
+template <typename StringType>
+static void appendGroupedNumber(StringType& out, std::string_view number,
+                                const DigitGrouping& grouping) {
+   std::less<const char *> before;
+   if (!before(number.data(), out.data())
+       && before(number.data(), out.data() + out.length())) {
+      std::string copy(number);
+      appendGroupedNumber(out, std::string_view(copy), grouping);
+      return;
+   }
+   int len = number.length();
+   int digitsStart = (len > 0 && (number[0] == '-' || number[0] == '+')) ? 1 : 0;
+   int digitsEnd = digitsStart;
+   while (digitsEnd < len && isdigit((unsigned char) number[digitsEnd])) {
+      digitsEnd++;
+   }
+   int nDigits = digitsEnd - digitsStart;
+   int nTail = len - digitsEnd;
+
+   size_t oldLength = out.length();
+   out.resize(oldLength + len + countSeparators(nDigits, grouping.grouping));
+   char *p = &out[0] + out.length();
+
+   p -= nTail;
+   if (nTail > 0) {
+      memcpy(p, number.data() + digitsEnd, nTail);
+      if (*p == '.') *p = grouping.decimalPoint;
+   }
+   GroupCursor cursor(grouping.grouping);
+   for (int i = digitsEnd - 1; i >= digitsStart; i--) {
+      if (cursor.separatorBeforeNextDigit()) *--p = grouping.separator;
+      *--p = number[i];
+   }
+   if (digitsStart > 0) *--p = number[0];
+}
+
+void appendWithCommas(std::string& out, std::string_view number,
+                      const DigitGrouping& grouping) {
+   WCLIB_INSTRUMENT_SCOPE("appendWithCommas");
+   appendGroupedNumber(out, number, grouping);
+}
+
+#if defined(__cpp_lib_memory_resource)
+void appendWithCommas(std::pmr::string& out, std::string_view number,
+                      const DigitGrouping& grouping) {
+   WCLIB_INSTRUMENT_SCOPE("appendWithCommas");
+   appendGroupedNumber(out, number, grouping);
+}
+#endif
+
+std::string formatWithCommas(const std::string& number,
+                             const DigitGrouping& grouping) {
+   std::string result;
+   appendWithCommas(result, number, grouping);
+   return result;
+}
+
+#if defined(__cpp_lib_memory_resource)
+std::pmr::string formatWithCommas(const std::string& number,
+                                  std::pmr::memory_resource *resource,
+                                  const DigitGrouping& grouping) {
+   std::pmr::string result(resource);
+   appendWithCommas(result, number, grouping);
+   return result;
+}
+#endif
+
+/*
+ * Implementation notes: StringPipeline
+ * ------------------------------------
+ * The input goes through three phases.  Until every trimStart and
+ * capitalize stage has passed its first character, each character is
+ * run through the stages one at a time, which also records the output
+ * length after the last character that reached each trimEnd stage as
+ * non-whitespace.  The rest of the input then goes through the
+ * compiled tables alone; the store is unconditional and the output
+ * length advances only for kept characters, so the loop has no
+ * branches.  Finally, each trimEnd stage scans backward from the end of
+ * the input for the last byte that reaches it as non-whitespace, and
+ * the output characters produced after that byte are dropped.
+ */
+
+std::string StringPipeline::apply(std::string_view str) const {
+   std::string result(maxLength(str.length()), '\0');
+   result.resize(apply(str, &result[0]));
+   return result;
+}
+
+#if defined(__cpp_lib_memory_resource)
+std::pmr::string StringPipeline::apply(std::string_view str,
+                                       std::pmr::memory_resource *resource) const {
+   std::pmr::string result(maxLength(str.length()), '\0', resource);
+   result.resize(apply(str, &result[0]));
+   return result;
+}
+#endif
+
+size_t StringPipeline::maxLength(size_t inputLength) const {
+   if (!grouped) return inputLength;
+   int smallest = INT_MAX;
+   for (int i = 0; i < nGroupSizes && GroupCursor::isGroupSize(groupSizes[i]); i++) {
+      smallest = std::min(smallest, int(groupSizes[i]));
+   }
+   return (smallest == INT_MAX) ? inputLength : inputLength + inputLength / smallest;
+}
+
+size_t StringPipeline::apply(std::string_view str, char *dst) const {
+   WCLIB_INSTRUMENT_SCOPE("StringPipeline::apply");
+   if (!compiled) error("StringPipeline::apply: the pipeline has not been built");
+   bool started[MAX_STAGES] = {};
+   size_t endMarks[MAX_STAGES] = {};
+   int nWaiting = nPositional;
+   const unsigned char *src = (const unsigned char *) str.data();
+   size_t len = str.length();
+   size_t i = 0;
+   size_t n = 0;
+   while (nWaiting > 0 && i < len) {
+      unsigned char ch = src[i++];
+      bool alive = true;
+      uint32_t marked = 0;
+      for (int s = 0; alive && s < nStages; s++) {
+         StageType type = stages[s].type;
+         if (type == LOWER) {
+            ch = lowerByte(ch);
+         } else if (type == UPPER) {
+            ch = upperByte(ch);
+         } else if (type == REMOVE) {
+            alive = !testBit(stages[s].chars, ch);
+         } else if (type == CAPITALIZE) {
+            if (started[s]) {
+               ch = lowerByte(ch);
+            } else {
+               ch = upperByte(ch);
+               started[s] = true;
+               nWaiting--;
+            }
+         } else if (type == TRIM_START) {
+            if (!started[s]) {
+               alive = !isSpaceByte(ch);
+               if (alive) {
+                  started[s] = true;
+                  nWaiting--;
+               }
+            }
+         } else if (!isSpaceByte(ch)) {
+            marked |= uint32_t(1) << s;
+         }
+      }
+      if (alive) dst[n++] = (char) ch;
+      for (int s = 0; marked != 0; s++, marked >>= 1) {
+         if (marked & 1) endMarks[s] = n;
+      }
+   }
+   size_t bodyStart = i;
+   for (; i < len; i++) {
+      unsigned char ch = src[i];
+      dst[n] = (char) charMap[ch];
+      n += kept[ch];
+   }
+   size_t finish = n;
+   for (int s = 0; s < nStages; s++) {
+      if (stages[s].type != TRIM_END) continue;
+      size_t j = len;
+      size_t nAfter = 0;
+      while (j > bodyStart && !testBit(stages[s].chars, src[j - 1])) {
+         nAfter += kept[src[j - 1]];
+         j--;
+      }
+      size_t mark = (j > bodyStart) ? n - nAfter : endMarks[s];
+      finish = std::min(finish, mark);
+   }
+   if (grouped) finish = groupInPlace(dst, finish);
+   return finish;
+}
+
+/*
+ * Implementation notes: groupInPlace
+ * ----------------------------------
+ * Works from the back of the buffer, as appendWithCommas does.  The
+ * write position never falls behind the digit being read, so the
+ * digits can be moved into place without a second buffer.
+ */
+
+size_t StringPipeline::groupInPlace(char *dst, size_t len) const {
+   size_t digitsStart = (len > 0 && (dst[0] == '-' || dst[0] == '+')) ? 1 : 0;
+   size_t digitsEnd = digitsStart;
+   while (digitsEnd < len && isdigit((unsigned char) dst[digitsEnd])) {
+      digitsEnd++;
+   }
+   std::string_view sizes(groupSizes, nGroupSizes);
+   size_t nSeparators = countSeparators(digitsEnd - digitsStart, sizes);
+   size_t nTail = len - digitsEnd;
+   char *p = dst + len + nSeparators - nTail;
+   if (nTail > 0) {
+      memmove(p, dst + digitsEnd, nTail);
+      if (*p == '.') *p = groupDecimalPoint;
+   }
+   GroupCursor cursor(sizes);
+   for (size_t i = digitsEnd; i > digitsStart; i--) {
+      if (cursor.separatorBeforeNextDigit()) *--p = groupSeparator;
+      *--p = dst[i - 1];
+   }
+   return len + nSeparators;
+}
+
+#include <atomic>
+#include <exception>
+#include <thread>
+
+StringBatch::StringBatch() : bounds(1, 0) {
+   /* Empty */
+}
+
+StringBatch::StringBatch(std::string text, std::vector<size_t> offsets)
+   : allText(std::move(text)), bounds(std::move(offsets)) {
+   if (bounds.empty() || bounds.back() != allText.length()) {
+      error("StringBatch: offsets do not match the text");
+   }
+}
+
+size_t StringBatch::size() const {
+   return bounds.size() - 1;
+}
+
+bool StringBatch::isEmpty() const {
+   return size() == 0;
+}
+
+std::string_view StringBatch::operator[](size_t index) const {
+   if (index >= size()) error("StringBatch::operator[]: index out of range");
+   return std::string_view(allText.data() + bounds[index],
+                           bounds[index + 1] - bounds[index]);
+}
+
+const std::string& StringBatch::text() const {
+   return allText;
+}
+
+const std::vector<size_t>& StringBatch::offsets() const {
+   return bounds;
+}
+
+size_t recordStart(std::string_view text, size_t pos) {
+   if (pos == 0 || pos >= text.length()) return std::min(pos, text.length());
+   if (text[pos - 1] == '\n') return pos;
+   const void *newline = memchr(text.data() + pos, '\n', text.length() - pos);
+   if (newline == NULL) return text.length();
+   return (const char *) newline - text.data() + 1;
+}
+
+/*
+ * Implementation notes: runRecordChunks
+ * -------------------------------------
+ * Each worker claims the next unprocessed chunk from a shared counter,
+ * so the load balances itself however uneven the records are.  Every
+ * chunk is transformed into its own buffer; once all are done, the
+ * workers claim the chunks again to copy them into the final text and
+ * shift their offsets, which is the only place the results move.  An
+ * exception in any worker is rethrown on the calling thread after the
+ * others have stopped.
+ */
+
+namespace {
+   template <typename FunctorType>
+   void runOnWorkers(size_t nChunks, FunctorType fn) {
+      size_t nThreads = std::min(size_t(std::thread::hardware_concurrency()), nChunks);
+      std::atomic<size_t> next(0);
+      std::vector<std::exception_ptr> failures(std::max(nThreads, size_t(1)));
+      auto work = [&](size_t worker) {
+         try {
+            size_t chunk;
+            while ((chunk = next.fetch_add(1, std::memory_order_relaxed)) < nChunks) {
+               fn(chunk);
+            }
+         } catch (...) {
+            failures[worker] = std::current_exception();
+            next.store(nChunks, std::memory_order_relaxed);
+         }
+      };
+      std::vector<std::thread> threads;
+      for (size_t i = 1; i < nThreads; i++) {
+         threads.emplace_back(work, i);
+      }
+      work(0);
+      for (std::thread& thread : threads) {
+         thread.join();
+      }
+      for (std::exception_ptr& failure : failures) {
+         if (failure) std::rethrow_exception(failure);
+      }
+   }
 }
 
-std::string trimEnd(const std::string& str) {
-    std::string str2 = str;
-    trimEndInPlace(str2);
-    return str2;
+StringBatch runRecordChunks(size_t nChunks,
+                            const std::function<void(size_t chunk, std::string& out,
+                                                     std::vector<size_t>& ends)>& fn) {
+   WCLIB_INSTRUMENT_SCOPE("runRecordChunks");
+   std::vector<std::string> chunkText(nChunks);
+   std::vector<std::vector<size_t> > chunkEnds(nChunks);
+   runOnWorkers(nChunks, [&](size_t chunk) {
+      fn(chunk, chunkText[chunk], chunkEnds[chunk]);
+   });
+   std::vector<size_t> textStart(nChunks + 1, 0);
+   std::vector<size_t> firstRecord(nChunks + 1, 0);
+   for (size_t i = 0; i < nChunks; i++) {
+      textStart[i + 1] = textStart[i] + chunkText[i].length();
+      firstRecord[i + 1] = firstRecord[i] + chunkEnds[i].size();
+   }
+   std::string text(textStart[nChunks], '\0');
+   std::vector<size_t> offsets(firstRecord[nChunks] + 1, 0);
+   offsets.back() = text.length();
+   runOnWorkers(nChunks, [&](size_t chunk) {
+      memcpy(&text[0] + textStart[chunk], chunkText[chunk].data(),
+             chunkText[chunk].length());
+      std::string().swap(chunkText[chunk]);
+      size_t *dst = offsets.data() + firstRecord[chunk] + 1;
+      for (size_t end : chunkEnds[chunk]) {
+         *dst++ = textStart[chunk] + end;
+      }
+   });
+   return StringBatch(std::move(text), std::move(offsets));
 }
 
-void trimEndInPlace(std::string& str) {
-    int end = (int)str.length();
-    int finish = end;
-    while (finish > 0 && isspace(str[finish - 1])) {
-        finish--;
-    }
-    if (finish < end) {
-        str.erase(finish, end - finish);
-    }
+StringBatch StringPipeline::applyToRecords(std::string_view text) const {
+   return transformRecords(text, [this](std::string_view record, std::string& out) {
+      size_t oldLength = out.length();
+      out.resize(oldLength + maxLength(record.length()));
+      out.resize(oldLength + apply(record, &out[oldLength]));
+   });
 }
 
-std::string trimStart(const std::string& str) {
-    std::string str2 = str;
-    trimStartInPlace(str2);
-    return str2;
+StringBatch StringPipeline::applyToRecords(const std::string_view *records,
+                                           size_t count) const {
+   return transformRecords(records, count, [this](std::string_view record, std::string& out) {
+      size_t oldLength = out.length();
+      out.resize(oldLength + maxLength(record.length()));
+      out.resize(oldLength + apply(record, &out[oldLength]));
+   });
 }
 
-void trimStartInPlace(std::string& str) {
-    int start = 0;
-    int finish = (int)str.length() - 1;
-    while (start <= finish && isspace(str[start])) {
-        start++;
-    }
-    if (start > 0) {
-        str.erase(0, start);
-    }
+StringBatch StringPipeline::applyToRecords(const std::vector<std::string_view>& records) const {
+   return applyToRecords(records.data(), records.size());
 }
 
 /*
@@ -221,6 +1976,153 @@ std::string getLine(std::string prompt) {
     return line;
 }
 
+/*
+ * Implementation notes: parseInteger, parseReal
+ * ---------------------------------------------
+ * These functions use std::from_chars, which parses in place without
+ * consulting the locale.  Unlike the stream extractors, from_chars does
+ * not accept a leading plus sign, so one is skipped here.  Standard
+ * libraries without floating-point from_chars fall back on strtod,
+ * which needs a terminated copy of the text.  Both would also accept
+ * spellings such as "inf" and "nan" (and strtod hexadecimal numbers),
+ * which getReal's stream extraction rejects, so parseReal first
+ * checks that the text holds only decimal digits, signs, points and
+ * exponents.
+ */
+
+namespace {
+   std::string_view numberText(std::string_view text) {
+      text = trimView(text);
+      if (text.length() > 1 && text[0] == '+' && text[1] != '-') {
+         text.remove_prefix(1);
+      }
+      return text;
+   }
+}
+
+bool parseInteger(std::string_view text, int& value) {
+   text = numberText(text);
+   if (text.empty()) return false;
+   const char *end = text.data() + text.length();
+   std::from_chars_result result = std::from_chars(text.data(), end, value);
+   return result.ec == std::errc() && result.ptr == end;
+}
+
+bool parseReal(std::string_view text, double& value) {
+   text = numberText(text);
+   if (text.empty()) return false;
+   if (text.find_first_not_of("0123456789+-.eE") != std::string_view::npos) {
+      return false;
+   }
+#if defined(__cpp_lib_to_chars)
+   const char *end = text.data() + text.length();
+   std::from_chars_result result = std::from_chars(text.data(), end, value);
+   return result.ec == std::errc() && result.ptr == end;
+#else
+   std::string copy(text);
+   char *end;
+   errno = 0;
+   value = strtod(copy.c_str(), &end);
+   return errno == 0 && end == copy.c_str() + copy.length();
+#endif
+}
+
+LineReader::LineReader(std::istream& in, size_t bufferSize) {
+   source = in.rdbuf();
+   if (source == NULL) error("LineReader: stream has no buffer");
+   buffer.resize(std::max(bufferSize, size_t(64)));
+   start = scanned = end = 0;
+   atEnd = false;
+   lines = 0;
+}
+
+/*
+ * Implementation notes: LineReader::next
+ * --------------------------------------
+ * Lines are found with memchr in the buffered text.  When the text
+ * runs out before a newline, the partial line is moved to the front of
+ * the buffer and more input is read after it, doubling the buffer only
+ * if the line is longer than the whole buffer.
+ */
+
+bool LineReader::next(std::string_view& line) {
+   while (true) {
+      char *base = buffer.data();
+      const char *newline = static_cast<const char *>(
+         memchr(base + scanned, '\n', end - scanned));
+      size_t length;
+      if (newline != NULL) {
+         length = newline - (base + start);
+         scanned = start + length + 1;
+      } else if (atEnd) {
+         if (start == end) return false;
+         length = end - start;
+         scanned = end;
+      } else {
+         if (start > 0) {
+            memmove(base, base + start, end - start);
+            end -= start;
+            start = 0;
+         }
+         scanned = end;
+         if (end == buffer.size()) buffer.resize(2 * buffer.size());
+         std::streamsize n = source->sgetn(buffer.data() + end, buffer.size() - end);
+         if (n <= 0) {
+            atEnd = true;
+         } else {
+            end += n;
+         }
+         continue;
+      }
+      line = std::string_view(base + start, length);
+      if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+      start = scanned;
+      lines++;
+      return true;
+   }
+}
+
+long LineReader::lineNumber() const {
+   return lines;
+}
+
+namespace {
+   template <typename ValueType, typename ParseFn>
+   size_t readValues(std::istream& in, std::vector<ValueType>& values,
+                     BadInputPolicy policy, ParseFn parse, const char *message) {
+      LineReader reader(in);
+      std::string_view line;
+      ValueType value;
+      size_t count = 0;
+      while (reader.next(line)) {
+         if (parse(line, value)) {
+            values.push_back(value);
+            count++;
+         } else if (policy == BAD_INPUT_STOP) {
+            break;
+         } else if (policy == BAD_INPUT_ERROR) {
+            error(std::string(message) + " on line "
+                  + std::to_string(reader.lineNumber()));
+         }
+      }
+      return count;
+   }
+}
+
+size_t readIntegers(std::istream& in, std::vector<int>& values,
+                    BadInputPolicy policy) {
+   WCLIB_INSTRUMENT_SCOPE("readIntegers");
+   return readValues(in, values, policy, parseInteger,
+                     "readIntegers: Illegal integer format");
+}
+
+size_t readReals(std::istream& in, std::vector<double>& values,
+                 BadInputPolicy policy) {
+   WCLIB_INSTRUMENT_SCOPE("readReals");
+   return readValues(in, values, policy, parseReal,
+                     "readReals: Illegal numeric format");
+}
+
 /*
  * File: lexicon.cpp
  * -----------------
@@ -234,9 +2136,8 @@ std::string getLine(std::string prompt) {
  * format.  The STL set is for words added piecemeal at runtime.
  *
  * The DAWG idea comes from an article by Appel & Jacobson, CACM May 1988.
- * This lexicon implementation only has the code to load/search the DAWG.
- * The DAWG builder code is quite a bit more intricate, see me (Julie)
- * if you need it.
+ * Words added at runtime can be folded into a newly built minimal DAWG
+ * with compact(); see the notes on DawgBuilder below.
  */
 
 /*************************************************************************/
@@ -263,8 +2164,19 @@ std::string getLine(std::string prompt) {
 #include <algorithm>
 #include <cstdlib>
 #include <iostream>
+#include <bitset>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 #include "util.h"
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 /*
  * The DAWG is stored as an array of edges. Each edge is represented by
  * one 32-bit struct.  The 5 "letter" bits indicate the character on this
@@ -281,16 +2193,49 @@ std::string getLine(std::string prompt) {
 Lexicon::Lexicon() {
    edges = start = NULL;
    numEdges = numDawgWords = 0;
+   mappedData = NULL;
+   mappedSize = 0;
+   childIndexEnabled = LEXICON_CHILD_INDEX;
+   rankIndexReady.store(false, std::memory_order_relaxed);
 }
 
 Lexicon::Lexicon(std::string filename) {
    edges = start = NULL;
    numEdges = numDawgWords = 0;
+   mappedData = NULL;
+   mappedSize = 0;
+   childIndexEnabled = LEXICON_CHILD_INDEX;
+   rankIndexReady.store(false, std::memory_order_relaxed);
    addWordsFromFile(filename);
 }
 
 Lexicon::~Lexicon() {
-   if (edges) delete[] edges;
+   releaseEdges();
+}
+
+/*
+ * Implementation notes: releaseEdges
+ * ----------------------------------
+ * The edge array is either owned (allocated with new[]) or a view into
+ * a read-only memory mapping of a native binary file, in which case
+ * the mapping is what must be released.
+ */
+
+void Lexicon::releaseEdges() {
+   if (mappedData != NULL) {
+#ifndef _WIN32
+      munmap(mappedData, mappedSize);
+#endif
+      mappedData = NULL;
+      mappedSize = 0;
+   } else if (edges != NULL) {
+      delete[] edges;
+   }
+   edges = start = NULL;
+   numEdges = 0;
+   std::vector<uint32_t>().swap(childMasks);
+   std::vector<int>().swap(wordsThrough);
+   rankIndexReady.store(false, std::memory_order_relaxed);
 }
 
 /*
@@ -305,6 +2250,32 @@ static uint32_t my_ntohl(uint32_t arg) {
    return result;
 }
 
+/*
+ * Lookup helpers: lowercaseView returns word in lowercase, converting
+ * it into storage only if it contains characters that could change;
+ * prefetch asks for the cache line holding p to be loaded early.
+ */
+
+namespace {
+   std::string_view lowercaseView(std::string_view word, std::string& storage) {
+      for (char ch : word) {
+         if ((ch >= 'A' && ch <= 'Z') || (ch & 0x80)) {
+            storage = toLowerCase(word);
+            return storage;
+         }
+      }
+      return word;
+   }
+
+   inline void prefetch(const void *p) {
+#if defined(__GNUC__)
+      __builtin_prefetch(p);
+#else
+      (void) p;
+#endif
+   }
+}
+
 /*
  * Implementation notes: readBinaryFile
  * ------------------------------------
@@ -313,6 +2284,7 @@ static uint32_t my_ntohl(uint32_t arg) {
  */
 
 void Lexicon::readBinaryFile(std::string filename) {
+   WCLIB_INSTRUMENT_SCOPE("Lexicon::readBinaryFile");
    long startIndex, numBytes;
    char firstFour[4], expected[] = "DAWG";
    std::ifstream istr(filename.c_str(), std::ios::in | std::ios::binary);
@@ -320,7 +2292,14 @@ void Lexicon::readBinaryFile(std::string filename) {
    if (istr.fail()) {
       error("Couldn't open lexicon file " + filename);
    }
+   releaseEdges();
+   numDawgWords = 0;
    istr.read(firstFour, 4);
+   if (strncmp(firstFour, expected, 4) == 0 && istr.peek() == '2') {
+      istr.close();
+      readNativeBinaryFile(filename);
+      return;
+   }
    istr.get();
    istr >> startIndex;
    istr.get();
@@ -331,6 +2310,13 @@ void Lexicon::readBinaryFile(std::string filename) {
       error("Improperly formed lexicon file " + filename);
    }
    numEdges = numBytes/sizeof(Edge);
+   if (numEdges == 0) {
+      istr.close();
+      return;
+   }
+   if (startIndex >= numEdges) {
+      error("Improperly formed lexicon file " + filename);
+   }
    edges = new Edge[numEdges];
    start = &edges[startIndex];
    istr.read((char *)edges, numBytes);
@@ -345,21 +2331,731 @@ void Lexicon::readBinaryFile(std::string filename) {
    }
 #endif
 
-   istr.close();
-   numDawgWords = countDawgWords(start);
+   istr.close();
+   checkEdges(filename);
+   numDawgWords = (start != NULL) ? dawgWordsThroughNode(start) : 0;
+   rebuildChildIndex();
+}
+
+/*
+ * Implementation notes: checkEdges
+ * --------------------------------
+ * Every edge read from a file is checked once, as it is loaded, so
+ * that the rest of the class can index by children and walk sibling
+ * runs without bounds checks: each child index must lie inside the
+ * edge array, and the final edge must end its run, which guarantees
+ * that every sibling walk stops before the end of the array.  A
+ * lexicon that fails the check is left empty.
+ */
+
+void Lexicon::checkEdges(std::string filename) {
+   bool valid = numEdges == 0 || edges[numEdges - 1].lastEdge;
+   for (int i = 0; valid && i < numEdges; i++) {
+      valid = (long) edges[i].children < numEdges;
+   }
+   if (!valid) {
+      releaseEdges();
+      numDawgWords = 0;
+      error("Improperly formed lexicon file " + filename);
+   }
+}
+
+/*
+ * Implementation notes: readNativeBinaryFile
+ * ------------------------------------------
+ * The native binary format (conventionally named with a .dawg2
+ * extension) is a fixed-size header followed by the edge array exactly
+ * as it is laid out in memory, so on a machine with the byte order
+ * recorded in the header the file is mapped read-only and used in
+ * place: there is no read, no byte swapping and no counting pass, and
+ * every process that loads the same file shares its pages.  A file
+ * written with the other byte order is still accepted, but is copied
+ * into memory and swapped.  Either way, any DAWG the lexicon already
+ * holds is released first.
+ */
+
+namespace {
+   const char DAWG2_MAGIC[8] = { 'D', 'A', 'W', 'G', '2', 0, 0, 0 };
+   const uint32_t DAWG2_BYTE_ORDER_MARK = 0x01020304;
+
+   struct Dawg2Header {
+      char magic[8];            /* DAWG2_MAGIC                          */
+      uint32_t byteOrderMark;   /* DAWG2_BYTE_ORDER_MARK, native order  */
+      uint32_t startIndex;      /* Index of the first edge of the root  */
+      uint32_t numEdges;        /* Number of edges that follow          */
+      uint32_t numWords;        /* Number of words in the DAWG          */
+      uint32_t reserved[2];     /* Zero; pads the header to 32 bytes    */
+   };
+
+   bool isValidDawg2Header(Dawg2Header& header, size_t fileSize, bool& swapped) {
+      if (fileSize < sizeof(Dawg2Header)
+          || memcmp(header.magic, DAWG2_MAGIC, sizeof(DAWG2_MAGIC)) != 0) {
+         return false;
+      }
+      swapped = header.byteOrderMark != DAWG2_BYTE_ORDER_MARK;
+      if (swapped) {
+         if (header.byteOrderMark != my_ntohl(DAWG2_BYTE_ORDER_MARK)) return false;
+         header.startIndex = my_ntohl(header.startIndex);
+         header.numEdges = my_ntohl(header.numEdges);
+         header.numWords = my_ntohl(header.numWords);
+      }
+      return (fileSize - sizeof(Dawg2Header)) / sizeof(uint32_t) >= header.numEdges
+             && (header.numEdges == 0 || header.startIndex < header.numEdges);
+   }
+}
+
+void Lexicon::readNativeBinaryFile(std::string filename) {
+   static_assert(sizeof(Edge) == sizeof(uint32_t), "Lexicon::Edge must be 32 bits");
+   Dawg2Header header;
+   bool swapped = false;
+   const char *edgeData = NULL;
+   std::string contents;
+   releaseEdges();
+   numDawgWords = 0;
+#ifndef _WIN32
+   int fd = open(filename.c_str(), O_RDONLY);
+   if (fd < 0) {
+      error("Couldn't open lexicon file " + filename);
+   }
+   struct stat st;
+   void *base = MAP_FAILED;
+   if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+   }
+   close(fd);
+   if (base == MAP_FAILED) {
+      error("Couldn't map lexicon file " + filename);
+   }
+   size_t fileSize = st.st_size;
+   memcpy(&header, base, std::min(fileSize, sizeof(Dawg2Header)));
+   if (!isValidDawg2Header(header, fileSize, swapped)) {
+      munmap(base, fileSize);
+      error("Improperly formed lexicon file " + filename);
+   }
+   edgeData = (const char *) base + sizeof(Dawg2Header);
+   if (!swapped && header.numEdges > 0) {
+      mappedData = base;
+      mappedSize = fileSize;
+      edges = (Edge *) edgeData;
+   }
+#else
+   std::ifstream istr(filename.c_str(), std::ios::in | std::ios::binary);
+   if (istr.fail()) {
+      error("Couldn't open lexicon file " + filename);
+   }
+   contents.assign(std::istreambuf_iterator<char>(istr), std::istreambuf_iterator<char>());
+   size_t fileSize = contents.length();
+   memcpy(&header, contents.data(), std::min(fileSize, sizeof(Dawg2Header)));
+   if (!isValidDawg2Header(header, fileSize, swapped)) {
+      error("Improperly formed lexicon file " + filename);
+   }
+   edgeData = contents.data() + sizeof(Dawg2Header);
+#endif
+   numEdges = header.numEdges;
+   numDawgWords = header.numWords;
+   if (mappedData == NULL && numEdges > 0) {
+      edges = new Edge[numEdges];
+      memcpy(edges, edgeData, numEdges * sizeof(Edge));
+      if (swapped) {
+         uint32_t *cur = (uint32_t *) edges;
+         for (int i = 0; i < numEdges; i++, cur++) {
+            *cur = my_ntohl(*cur);
+         }
+      }
+   }
+#ifndef _WIN32
+   if (mappedData == NULL) {
+      munmap(base, fileSize);
+   }
+#endif
+   start = (numEdges > 0) ? &edges[header.startIndex] : NULL;
+   checkEdges(filename);
+   rebuildChildIndex();
+}
+
+/*
+ * Implementation notes: saveNativeBinary
+ * --------------------------------------
+ * Writes the header described under readNativeBinaryFile followed by
+ * the edge array in this machine's byte order.
+ */
+
+void Lexicon::saveNativeBinary(std::string filename) const {
+   if (!otherWords.empty()) {
+      Lexicon compacted(*this);
+      compacted.compactForSave("Lexicon::saveNativeBinary");
+      compacted.saveNativeBinary(filename);
+      return;
+   }
+   std::ofstream ostr(filename.c_str(), std::ios::out | std::ios::binary);
+   if (ostr.fail()) {
+      error("Couldn't create lexicon file " + filename);
+   }
+   Dawg2Header header;
+   memset(&header, 0, sizeof(header));
+   memcpy(header.magic, DAWG2_MAGIC, sizeof(DAWG2_MAGIC));
+   header.byteOrderMark = DAWG2_BYTE_ORDER_MARK;
+   header.startIndex = (start != NULL) ? start - edges : 0;
+   header.numEdges = numEdges;
+   header.numWords = numDawgWords;
+   ostr.write((const char *) &header, sizeof(header));
+   if (numEdges > 0) {
+      ostr.write((const char *) edges, numEdges * sizeof(Edge));
+   }
+   ostr.close();
+   if (ostr.fail()) {
+      error("Couldn't write lexicon file " + filename);
+   }
+}
+
+/*
+ * Implementation notes: saveBinary
+ * --------------------------------
+ * Writes the portable format read by readBinaryFile, whose edges are
+ * stored in big-endian byte order.
+ */
+
+void Lexicon::saveBinary(std::string filename) const {
+   if (!otherWords.empty()) {
+      Lexicon compacted(*this);
+      compacted.compactForSave("Lexicon::saveBinary");
+      compacted.saveBinary(filename);
+      return;
+   }
+   std::ofstream ostr(filename.c_str(), std::ios::out | std::ios::binary);
+   if (ostr.fail()) {
+      error("Couldn't create lexicon file " + filename);
+   }
+   long startIndex = (start != NULL) ? start - edges : 0;
+   ostr << "DAWG:" << startIndex << ":" << numEdges * sizeof(Edge) << ":";
+   const uint32_t *cur = (const uint32_t *) edges;
+   for (int i = 0; i < numEdges; i++, cur++) {
+#if defined(BYTE_ORDER) && BYTE_ORDER == LITTLE_ENDIAN
+      uint32_t word = my_ntohl(*cur);
+#else
+      uint32_t word = *cur;
+#endif
+      ostr.write((const char *) &word, sizeof(word));
+   }
+   ostr.close();
+   if (ostr.fail()) {
+      error("Couldn't write lexicon file " + filename);
+   }
+}
+
+void Lexicon::compactForSave(std::string caller) {
+   compact();
+   if (!otherWords.empty()) {
+      error(caller + ": lexicon contains words with characters other than a-z");
+   }
+}
+
+/*
+ * Implementation notes: DawgBuilder
+ * ---------------------------------
+ * The builder constructs a minimal DAWG incrementally from words added
+ * in strictly increasing order, following Daciuk et al., "Incremental
+ * Construction of Minimal Acyclic Finite-State Automata" (Computational
+ * Linguistics, 2000).  The nodes along the path of the most recently
+ * added word stay open; when the next word diverges from that path,
+ * the open nodes below the divergence point can no longer change, so
+ * each one is replaced by an equivalent node from the register if one
+ * exists, or added to the register otherwise.  Two nodes are equivalent
+ * when they have the same outgoing edges (letter, accept bit and child),
+ * so every shared suffix is stored only once.
+ *
+ * As in the Lexicon edge array, the accept bit belongs to an edge
+ * rather than to a node.  Once the root is closed, the registered
+ * nodes are laid out as contiguous runs of edges with the root first,
+ * which keeps index 0 (meaning "no children") from ever being the
+ * target of an edge.
+ */
+
+namespace {
+   class DawgBuilder {
+   public:
+      DawgBuilder() {
+         path.push_back(newNode());
+         numWords = 0;
+      }
+
+      /* Words must be nonempty, lowercase a-z, and in increasing order */
+      void add(std::string_view word) {
+         size_t common = 0;
+         while (common < word.length() && common < previous.length()
+                && word[common] == previous[common]) {
+            common++;
+         }
+         if (common == word.length() && common == previous.length()) return;
+         closePathBelow(common);
+         for (size_t i = common; i < word.length(); i++) {
+            int child = newNode();
+            Edge e = { (unsigned char) (word[i] - 'a' + 1), false, child };
+            nodes[path.back()].push_back(e);
+            path.push_back(child);
+         }
+         nodes[path[word.length() - 1]].back().accept = true;
+         previous.assign(word.data(), word.length());
+         numWords++;
+      }
+
+      int size() const {
+         return numWords;
+      }
+
+      /* Closes the graph and returns it as packed 32-bit edges */
+      std::vector<uint32_t> finish() {
+         closePathBelow(0);
+         std::vector<int> offsets(nodes.size(), 0);
+         std::vector<int> order;
+         int total = layOut(path[0], offsets, order, 0);
+         if (total >= (1 << 24)) {
+            error("Lexicon::compact: too many edges for the DAWG format");
+         }
+         std::vector<uint32_t> packed;
+         packed.reserve(total);
+         for (int id : order) {
+            const std::vector<Edge>& out = nodes[id];
+            for (size_t i = 0; i < out.size(); i++) {
+               uint32_t children = nodes[out[i].child].empty() ? 0 : offsets[out[i].child];
+               packed.push_back(out[i].letter
+                                | (uint32_t(i + 1 == out.size()) << 5)
+                                | (uint32_t(out[i].accept) << 6)
+                                | (children << 8));
+            }
+         }
+         return packed;
+      }
+
+   private:
+      struct Edge {
+         unsigned char letter;
+         bool accept;
+         int child;
+      };
+
+      struct NodeHash {
+         size_t operator()(const std::vector<Edge>& node) const {
+            size_t hash = node.size();
+            for (const Edge& e : node) {
+               hash = hash * 1000003 ^ (e.letter | (e.accept << 5) | (size_t(e.child) << 6));
+            }
+            return hash;
+         }
+      };
+
+      struct NodeEqual {
+         bool operator()(const std::vector<Edge>& a, const std::vector<Edge>& b) const {
+            if (a.size() != b.size()) return false;
+            for (size_t i = 0; i < a.size(); i++) {
+               if (a[i].letter != b[i].letter || a[i].accept != b[i].accept
+                   || a[i].child != b[i].child) {
+                  return false;
+               }
+            }
+            return true;
+         }
+      };
+
+      std::vector<std::vector<Edge> > nodes;
+      std::vector<int> freeNodes;
+      std::vector<int> path;
+      std::unordered_map<std::vector<Edge>, int, NodeHash, NodeEqual> registry;
+      std::string previous;
+      int numWords;
+
+      int newNode() {
+         if (!freeNodes.empty()) {
+            int id = freeNodes.back();
+            freeNodes.pop_back();
+            return id;
+         }
+         nodes.push_back(std::vector<Edge>());
+         return nodes.size() - 1;
+      }
+
+      /* Replaces or registers the open nodes deeper than depth */
+      void closePathBelow(size_t depth) {
+         while (path.size() > depth + 1) {
+            int child = path.back();
+            path.pop_back();
+            auto found = registry.find(nodes[child]);
+            if (found != registry.end()) {
+               nodes[path.back()].back().child = found->second;
+               nodes[child].clear();
+               freeNodes.push_back(child);
+            } else {
+               registry.emplace(nodes[child], child);
+            }
+         }
+      }
+
+      /* Assigns edge offsets to every nonempty node reachable from id */
+      int layOut(int id, std::vector<int>& offsets, std::vector<int>& order, int next) {
+         std::vector<int> stack(1, id);
+         std::vector<bool> placed(nodes.size(), false);
+         placed[id] = true;
+         while (!stack.empty()) {
+            int cur = stack.back();
+            stack.pop_back();
+            offsets[cur] = next;
+            order.push_back(cur);
+            next += nodes[cur].size();
+            for (const Edge& e : nodes[cur]) {
+               if (!placed[e.child] && !nodes[e.child].empty()) {
+                  placed[e.child] = true;
+                  stack.push_back(e.child);
+               }
+            }
+         }
+         return next;
+      }
+   };
+
+   bool isDawgWord(std::string_view word) {
+      if (word.empty()) return false;
+      for (char ch : word) {
+         if (ch < 'a' || ch > 'z') return false;
+      }
+      return true;
+   }
+}
+
+/*
+ * Implementation notes: compact
+ * -----------------------------
+ * forEachWord visits the words of both structures in alphabetical
+ * order, which is exactly the order the builder needs.
+ */
+
+void Lexicon::compact() {
+   WCLIB_INSTRUMENT_SCOPE("Lexicon::compact");
+   if (otherWords.empty()) return;
+   DawgBuilder builder;
+   std::vector<std::string> leftovers;
+   forEachWord([&builder, &leftovers](std::string_view word) {
+      if (isDawgWord(word)) {
+         builder.add(word);
+      } else {
+         leftovers.emplace_back(word);
+      }
+   });
+   std::vector<uint32_t> packed = builder.finish();
+   releaseEdges();
+   numEdges = packed.size();
+   numDawgWords = builder.size();
+   if (numEdges > 0) {
+      edges = new Edge[numEdges];
+      memcpy(edges, packed.data(), numEdges * sizeof(Edge));
+      start = edges;
+   }
+   clearOtherWords();
+   for (const std::string& word : leftovers) {
+      otherWords.emplace_hint(otherWords.end(), internWord(word));
+   }
+   rebuildChildIndex();
+}
+
+/*
+ * Implementation notes: rank index
+ * --------------------------------
+ * The rank index records, for every edge, the number of DAWG words
+ * that start with the letters leading to that edge's node and then
+ * continue through that edge or one of its elder siblings.  A node's
+ * word count is therefore the entry of its last edge, and the number
+ * of words below the elder siblings of an edge is the entry of the
+ * edge just before it, which makes both the position of a word and
+ * the word at a position computable in one walk down the DAWG.
+ *
+ * The counts are computed bottom-up with an explicit stack and
+ * memoized by node, so each node is counted once however many edges
+ * share it, and deep words cannot overflow the call stack.  The index
+ * is built on first use, or immediately when the total is needed to
+ * load a file that does not record its word count.
+ */
+
+const std::vector<int>& Lexicon::rankIndex() const {
+   if (!rankIndexReady.load(std::memory_order_acquire)) {
+      std::lock_guard<std::mutex> lock(rankIndexLock);
+      if (!rankIndexReady.load(std::memory_order_relaxed)) {
+         buildRankIndex();
+         rankIndexReady.store(true, std::memory_order_release);
+      }
+   }
+   return wordsThrough;
+}
+
+void Lexicon::buildRankIndex() const {
+   wordsThrough.assign(numEdges, 0);
+   if (start == NULL) return;
+   const int UNVISITED = -1, IN_PROGRESS = -2;
+   std::vector<int> nodeTotal(numEdges, UNVISITED);
+   std::vector<int> stack(1, start - edges);
+   while (!stack.empty()) {
+      int node = stack.back();
+      if (nodeTotal[node] >= 0) {
+         stack.pop_back();
+         continue;
+      }
+      bool ready = true;
+      for (Edge *ep = &edges[node]; ; ep++) {
+         if (ep == edges + numEdges) {
+            error("Lexicon: DAWG node has no last edge");
+         }
+         int child = ep->children;
+         if (child >= numEdges) {
+            error("Lexicon: DAWG edge points outside the graph");
+         }
+         if (child != 0 && nodeTotal[child] < 0) {
+            if (nodeTotal[child] == IN_PROGRESS) {
+               error("Lexicon: DAWG edges do not form an acyclic graph");
+            }
+            stack.push_back(child);
+            ready = false;
+         }
+         if (ep->lastEdge) break;
+      }
+      if (!ready) {
+         nodeTotal[node] = IN_PROGRESS;
+         continue;
+      }
+      int count = 0;
+      for (int i = node; ; i++) {
+         count += edges[i].accept;
+         if (edges[i].children != 0) count += nodeTotal[edges[i].children];
+         wordsThrough[i] = count;
+         if (edges[i].lastEdge) break;
+      }
+      nodeTotal[node] = count;
+      stack.pop_back();
+   }
+}
+
+int Lexicon::dawgWordsThroughNode(const Edge *node) const {
+   while (!node->lastEdge) node++;
+   return rankIndex()[node - edges];
+}
+
+/*
+ * Returns the number of DAWG words that precede word alphabetically,
+ * setting found to whether word itself is in the DAWG.
+ */
+
+int Lexicon::dawgWordsBefore(std::string_view word, bool& found) const {
+   found = false;
+   if (start == NULL) return 0;
+   const std::vector<int>& through = rankIndex();
+   Edge *node = start;
+   int index = 0;
+   for (size_t i = 0; i < word.length(); i++) {
+      // Signed, so that characters before 'a' sort before every letter
+      int ord = (int) charToOrd(word[i]);
+      Edge *ep = node;
+      while ((int) ep->letter < ord && !ep->lastEdge) ep++;
+      if ((int) ep->letter < ord) {
+         return index + through[ep - edges];
+      }
+      if (ep != node) index += through[ep - 1 - edges];
+      if ((int) ep->letter != ord) return index;
+      if (i + 1 == word.length()) {
+         found = ep->accept;
+         return index;
+      }
+      index += ep->accept;
+      if (ep->children == 0) return index;
+      node = &edges[ep->children];
+   }
+   return index;
+}
+
+std::string Lexicon::dawgWordAt(int index) const {
+   const std::vector<int>& through = rankIndex();
+   std::string word;
+   Edge *node = start;
+   while (true) {
+      int before = 0;
+      Edge *ep = node;
+      while (through[ep - edges] <= index) {
+         before = through[ep - edges];
+         ep++;
+      }
+      index -= before;
+      word.push_back(ordToChar(ep->letter));
+      if (ep->accept) {
+         if (index == 0) return word;
+         index--;
+      }
+      node = &edges[ep->children];
+   }
+}
+
+int Lexicon::indexOf(std::string_view word) const {
+   WCLIB_INSTRUMENT_SCOPE("Lexicon::indexOf");
+   std::string storage;
+   word = lowercaseView(word, storage);
+   bool found;
+   int index = dawgWordsBefore(word, found);
+   auto pos = otherWords.lower_bound(word);
+   if (!found && (pos == otherWords.end() || *pos != word)) return -1;
+   return index + std::distance(otherWords.begin(), pos);
+}
+
+/*
+ * Implementation notes: wordAt
+ * ----------------------------
+ * The position of the k-th extra word among all the words is k plus the
+ * number of DAWG words before it.  Scanning the extra words in order
+ * therefore either finds the requested word among them or tells how
+ * many of them precede it, which gives its position among the DAWG
+ * words.
+ */
+
+std::string Lexicon::wordAt(int index) const {
+   if (index < 0 || index >= size()) {
+      error("Lexicon::wordAt: index out of range");
+   }
+   int nOthersBefore = 0;
+   for (std::string_view other : otherWords) {
+      bool found;
+      int position = nOthersBefore + dawgWordsBefore(other, found);
+      if (position == index) return std::string(other);
+      if (position > index) break;
+      nOthersBefore++;
+   }
+   return dawgWordAt(index - nOthersBefore);
+}
+
+/*
+ * Implementation notes: suggest
+ * -----------------------------
+ * The search computes the Levenshtein distances between the target and
+ * every prefix of the lexicon's words, one row of the usual dynamic
+ * programming table per letter.  Row d holds the distances from the
+ * prefix of length d to each prefix of the target, and depends only on
+ * row d - 1 and the d-th letter, so the rows for a path are kept in a
+ * stack that follows the walk through the DAWG.  Once every entry in a
+ * row exceeds the bound, no extension of that prefix can come back
+ * within it and the branch is dropped.
+ *
+ * The bound starts at maxDistance and shrinks as results accumulate:
+ * once limit words are known at distances below the bound, words at the
+ * bound itself could never be returned.  The words added individually
+ * are scanned in order, reusing the rows for the prefix each one shares
+ * with the word before it.
+ */
+
+struct Lexicon::SuggestSearch {
+   std::string_view target;
+   int width;                               /* target.length() + 1       */
+   std::vector<int> rows;                   /* Row d starts at d * width */
+   std::string prefix;
+   int bound;
+   int limit;
+   std::vector<int> countAt;                /* Results at each distance  */
+   std::vector<std::pair<int, std::string> > results;
+
+   /* Computes row depth + 1 from row depth and returns its minimum */
+   int extend(int depth, char ch) {
+      size_t needed = size_t(depth + 2) * width;
+      if (rows.size() < needed) rows.resize(needed);
+      const int *previous = &rows[size_t(depth) * width];
+      int *row = &rows[size_t(depth + 1) * width];
+      row[0] = depth + 1;
+      int best = row[0];
+      for (int j = 1; j < width; j++) {
+         int cost = (target[j - 1] == ch) ? 0 : 1;
+         int d = std::min(previous[j - 1] + cost,
+                          std::min(previous[j], row[j - 1]) + 1);
+         row[j] = d;
+         if (d < best) best = d;
+      }
+      return best;
+   }
+
+   int distanceAt(int depth) const {
+      return rows[size_t(depth) * width + width - 1];
+   }
+
+   void addResult(int distance, std::string_view word) {
+      results.emplace_back(distance, std::string(word));
+      countAt[distance]++;
+      int closer = 0;
+      for (int d = 0; d < bound; d++) closer += countAt[d];
+      while (bound > 0 && closer >= limit) {
+         bound--;
+         closer -= countAt[bound];
+      }
+   }
+};
+
+std::vector<std::string> Lexicon::suggest(std::string_view word, int maxDistance,
+                                          int limit) const {
+   WCLIB_INSTRUMENT_SCOPE("Lexicon::suggest");
+   if (maxDistance < 0) error("Lexicon::suggest: maxDistance must be non-negative");
+   std::vector<std::string> suggestions;
+   if (limit <= 0) return suggestions;
+   std::string storage;
+   SuggestSearch search;
+   search.target = lowercaseView(word, storage);
+   search.width = search.target.length() + 1;
+   search.rows.resize(search.width);
+   for (int j = 0; j < search.width; j++) search.rows[j] = j;
+   search.bound = maxDistance;
+   search.limit = limit;
+   search.countAt.assign(maxDistance + 1, 0);
+   if (start != NULL) suggestFromDawg(start, 0, search);
+   suggestFromOtherWords(search);
+   std::sort(search.results.begin(), search.results.end());
+   for (const auto& result : search.results) {
+      if (result.first > search.bound || int(suggestions.size()) == limit) break;
+      suggestions.push_back(result.second);
+   }
+   return suggestions;
 }
 
-int Lexicon::countDawgWords(Edge *ep) const {
-   int count = 0;
-   while (true) {
-      if (ep->accept) count++;
-      if (ep->children != 0) {
-         count += countDawgWords(&edges[ep->children]);
+void Lexicon::suggestFromDawg(Edge *node, int depth, SuggestSearch& search) const {
+   for (Edge *ep = node; ; ep++) {
+      char ch = ordToChar(ep->letter);
+      if (search.extend(depth, ch) <= search.bound) {
+         search.prefix.push_back(ch);
+         int distance = search.distanceAt(depth + 1);
+         if (ep->accept && distance <= search.bound) {
+            search.addResult(distance, search.prefix);
+         }
+         if (ep->children != 0) {
+            suggestFromDawg(&edges[ep->children], depth + 1, search);
+         }
+         search.prefix.pop_back();
       }
       if (ep->lastEdge) break;
-      ep++;
    }
-   return count;
+}
+
+void Lexicon::suggestFromOtherWords(SuggestSearch& search) const {
+   std::string_view previous;
+   int computed = 0;          /* Rows 1..computed follow previous       */
+   bool pruned = false;       /* Row computed is entirely over the bound */
+   for (std::string_view word : otherWords) {
+      int common = 0;
+      int shared = std::min(previous.length(), word.length());
+      while (common < shared && previous[common] == word[common]) common++;
+      if (pruned && common >= computed) continue;
+      int depth = std::min(common, computed);
+      pruned = false;
+      while (depth < int(word.length())) {
+         int best = search.extend(depth, word[depth]);
+         depth++;
+         if (best > search.bound) {
+            pruned = true;
+            break;
+         }
+      }
+      previous = word;
+      computed = depth;
+      if (!pruned && search.distanceAt(depth) <= search.bound) {
+         search.addResult(search.distanceAt(depth), word);
+      }
+   }
 }
 
 /*
@@ -367,28 +3063,150 @@ int Lexicon::countDawgWords(Edge *ep) const {
  * otherwise assume ASCII, one word per line
  */
 
+/*
+ * Implementation notes: WritableFileContents
+ * ------------------------------------------
+ * Holds the contents of a file in memory that may be modified.  Where
+ * mmap is available a regular file is mapped privately, so the pages
+ * are read on demand and changes never reach the file.  Pipes, devices
+ * and files such as those in /proc, which report no size, are read into
+ * a string instead, as is every file where mmap is not available.
+ */
+
+namespace {
+   class WritableFileContents {
+   public:
+      WritableFileContents(const std::string& filename) {
+         base = NULL;
+         length = 0;
+         mapped = false;
+#ifndef _WIN32
+         int fd = open(filename.c_str(), O_RDONLY);
+         if (fd < 0) {
+            error("Couldn't open lexicon file " + filename);
+         }
+         struct stat st;
+         if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void *p = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+               close(fd);
+               error("Couldn't map lexicon file " + filename);
+            }
+            base = (char *) p;
+            length = st.st_size;
+            mapped = true;
+         } else {
+            char buffer[65536];
+            ssize_t count;
+            while ((count = read(fd, buffer, sizeof buffer)) != 0) {
+               if (count < 0) {
+                  if (errno == EINTR) continue;
+                  close(fd);
+                  error("Couldn't read lexicon file " + filename);
+               }
+               contents.append(buffer, count);
+            }
+            base = &contents[0];
+            length = contents.length();
+         }
+         close(fd);
+#else
+         std::ifstream istr(filename.c_str(), std::ios::in | std::ios::binary);
+         if (istr.fail()) {
+            error("Couldn't open lexicon file " + filename);
+         }
+         contents.assign(std::istreambuf_iterator<char>(istr), std::istreambuf_iterator<char>());
+         base = &contents[0];
+         length = contents.length();
+#endif
+      }
+
+      ~WritableFileContents() {
+#ifndef _WIN32
+         if (mapped) munmap(base, length);
+#endif
+      }
+
+      char *data() {
+         return base;
+      }
+
+      size_t size() const {
+         return length;
+      }
+
+   private:
+      char *base;
+      size_t length;
+      bool mapped;
+      std::string contents;
+
+      WritableFileContents(const WritableFileContents&) = delete;
+      WritableFileContents& operator=(const WritableFileContents&) = delete;
+   };
+}
+
 void Lexicon::addWordsFromFile(std::string filename) {
-   char firstFour[4], expected[] = "DAWG";
-   std::ifstream istr(filename.c_str());
-   if (istr.fail()) {
-      error("Couldn't open lexicon file " + filename);
-   }
-   istr.read(firstFour, 4);
-   if (strncmp(firstFour, expected, 4) == 0) {
+   WCLIB_INSTRUMENT_SCOPE("Lexicon::addWordsFromFile");
+   WritableFileContents file(filename);
+   if (file.size() >= 4 && memcmp(file.data(), "DAWG", 4) == 0) {
       if (otherWords.size() != 0) {
          error("Binary files require an empty lexicon");
       }
       readBinaryFile(filename);
       return;
    }
-   istr.seekg(0);
-   std::string line;
-   while (getline(istr, line)) {
-      add(line);
+   addWordsFromText(file.data(), file.size());
+}
+
+/*
+ * Implementation notes: addWordsFromText
+ * --------------------------------------
+ * The whole text is lowercased in one call to the vectorized kernel,
+ * split into views at the newlines, sorted and stripped of duplicates.
+ * Each remaining word then needs only a DAWG lookup before it goes into
+ * otherWords; the words arrive in order, so an initially empty set is
+ * built by appending at its end, and otherwise each insertion starts
+ * from the position the search found.
+ */
+
+void Lexicon::addWordsFromText(char *text, size_t length) {
+   toLowerCase(std::string_view(text, length), text);
+   std::vector<std::string_view> words;
+   size_t pos = 0;
+   while (pos < length) {
+      const void *newline = memchr(text + pos, '\n', length - pos);
+      size_t finish = (newline == NULL) ? length : (const char *) newline - text;
+      std::string_view word(text + pos, finish - pos);
+      if (!word.empty() && word.back() == '\r') word.remove_suffix(1);
+      words.push_back(word);
+      pos = finish + 1;
+   }
+   std::sort(words.begin(), words.end());
+   words.erase(std::unique(words.begin(), words.end()), words.end());
+   bool appending = otherWords.empty();
+   for (std::string_view word : words) {
+      Edge *lastEdge = traceToLastEdge(word);
+      if (lastEdge && lastEdge->accept) continue;
+      if (appending) {
+         otherWords.emplace_hint(otherWords.end(), internWord(word));
+      } else {
+         auto hint = otherWords.lower_bound(word);
+         if (hint == otherWords.end() || *hint != word) {
+            otherWords.emplace_hint(hint, internWord(word));
+         }
+      }
    }
-   istr.close();
 }
 
+/*
+ * Implementation notes: equals
+ * ----------------------------
+ * Two lexicons holding only DAWG words with byte-identical edge arrays
+ * are equal without further work.  Otherwise both word sequences are
+ * walked together, which works because each is in alphabetical order.
+ */
+
 bool Lexicon::equals(const Lexicon& lex2) const {
     // optimization: if literally same lexicon, stop
     if (this == &lex2) {
@@ -397,17 +3215,20 @@ bool Lexicon::equals(const Lexicon& lex2) const {
     if (size() != lex2.size()) {
         return false;
     }
-
-    // compare both ways; each must be subset of the other
-    for (std::string s : *this) {
-        if (!lex2.contains(s))
-            return false;
+    if (otherWords.empty() && lex2.otherWords.empty() && numEdges == lex2.numEdges
+        && (numEdges == 0 || (start - edges == lex2.start - lex2.edges
+                              && memcmp(edges, lex2.edges, numEdges * sizeof(Edge)) == 0))) {
+        return true;
     }
-    for (std::string s : lex2) {
-        if (!contains(s))
+
+    WordCursor cursor1(this);
+    WordCursor cursor2(&lex2);
+    std::string_view word1, word2;
+    while (cursor1.next(word1)) {
+        if (!cursor2.next(word2) || word1 != word2)
             return false;
     }
-    return true;
+    return !cursor2.next(word2);
 }
 
 int Lexicon::size() const {
@@ -419,10 +3240,104 @@ bool Lexicon::isEmpty() const {
 }
 
 void Lexicon::clear() {
-   if (edges) delete[] edges;
-   edges = start = NULL;
-   numEdges = numDawgWords = 0;
+   releaseEdges();
+   numDawgWords = 0;
+   clearOtherWords();
+}
+
+/*
+ * Implementation notes: word arena
+ * --------------------------------
+ * The words in otherWords are views of characters copied into
+ * wordArena, which also supplies the nodes of the set.  Words are never
+ * removed one at a time, so the arena only grows until clear, compact
+ * or assignment empties the set and releases all of it at once.  A
+ * standard library without std::pmr gets the same views from a list of
+ * strings, whose nodes never move, and a set with the default
+ * allocator.
+ */
+
+std::string_view Lexicon::internWord(std::string_view word) {
+#if defined(__cpp_lib_memory_resource)
+   char *chars = static_cast<char *>(wordArena.allocate(word.length() + 1, 1));
+   memcpy(chars, word.data(), word.length());
+   chars[word.length()] = '\0';
+   return std::string_view(chars, word.length());
+#else
+   wordStore.emplace_front(word);
+   return wordStore.front();
+#endif
+}
+
+void Lexicon::clearOtherWords() {
    otherWords.clear();
+#if defined(__cpp_lib_memory_resource)
+   wordArena.release();
+#else
+   wordStore.clear();
+#endif
+}
+
+/*
+ * Implementation notes: child index
+ * ---------------------------------
+ * The optional child index holds, for the first edge of every node, a
+ * 26-bit mask of the letters on that node's edges.  Since the edges of
+ * a node are laid out in alphabetical order, the edge for a letter is
+ * at the offset given by the number of mask bits below the letter's
+ * bit, so finding a child takes one mask load and a popcount instead
+ * of a scan over up to 26 siblings.  Masks are stored in an array
+ * parallel to the edge array and are built whenever edges are loaded,
+ * built or copied.
+ */
+
+void Lexicon::setChildIndexEnabled(bool enabled) {
+   childIndexEnabled = enabled;
+   rebuildChildIndex();
+}
+
+bool Lexicon::isChildIndexEnabled() const {
+   return childIndexEnabled;
+}
+
+size_t Lexicon::childIndexMemoryUsage() const {
+   return childMasks.capacity() * sizeof(uint32_t);
+}
+
+void Lexicon::rebuildChildIndex() {
+   std::vector<uint32_t>().swap(childMasks);
+   if (!childIndexEnabled || start == NULL) return;
+   std::vector<int> nodes(1, start - edges);
+   for (int i = 0; i < numEdges; i++) {
+      if (edges[i].children >= (unsigned long) numEdges) {
+         error("Lexicon: DAWG edge points outside the graph");
+      }
+      if (edges[i].children != 0) nodes.push_back(edges[i].children);
+   }
+   childMasks.assign(numEdges, 0);
+   for (int node : nodes) {
+      if (childMasks[node] != 0) continue;
+      uint32_t mask = 0;
+      for (Edge *ep = &edges[node]; ; ep++) {
+         if (ep == edges + numEdges) {
+            std::vector<uint32_t>().swap(childMasks);
+            error("Lexicon: DAWG node has no last edge");
+         }
+         if (ep->letter >= 1 && ep->letter <= 26) {
+            mask |= uint32_t(1) << (ep->letter - 1);
+         }
+         if (ep->lastEdge) break;
+      }
+      childMasks[node] = mask;
+   }
+}
+
+static inline int popCount(uint32_t bits) {
+#if defined(__GNUC__)
+   return __builtin_popcount(bits);
+#else
+   return (int) std::bitset<32>(bits).count();
+#endif
 }
 
 /*
@@ -430,15 +3345,25 @@ void Lexicon::clear() {
  * -------------------------------------
  * Iterate over sequence of children to find one that
  * matches the given char.  Returns NULL if we get to
- * last child without finding a match (thus no such
- * child edge exists).
+ * last child, or to a child past the char in alphabetical
+ * order, without finding a match (thus no such child edge
+ * exists).  With the child index, the matching child is
+ * located directly.
  */
 
 Lexicon::Edge *Lexicon::findEdgeForChar(Edge *children, char ch) const {
+   unsigned int ord = charToOrd(ch);
+   if (!childMasks.empty()) {
+      if (ord - 1 >= 26) return NULL;
+      uint32_t mask = childMasks[children - edges];
+      uint32_t bit = uint32_t(1) << (ord - 1);
+      if ((mask & bit) == 0) return NULL;
+      return children + popCount(mask & (bit - 1));
+   }
    Edge *curEdge = children;
    while (true) {
-      if (curEdge->letter == charToOrd(ch)) return curEdge;
-      if (curEdge->lastEdge) return NULL;
+      if (curEdge->letter == ord) return curEdge;
+      if (curEdge->lastEdge || curEdge->letter > ord) return NULL;
       curEdge++;
    }
 }
@@ -450,8 +3375,8 @@ Lexicon::Edge *Lexicon::findEdgeForChar(Edge *children, char ch) const {
  * If a path exists, return last edge; otherwise return NULL.
  */
 
-Lexicon::Edge *Lexicon::traceToLastEdge(const std::string & s) const {
-   if (!start) return NULL;
+Lexicon::Edge *Lexicon::traceToLastEdge(std::string_view s) const {
+   if (!start || s.empty()) return NULL;
    Edge *curEdge = findEdgeForChar(start, s[0]);
    int len = (int) s.length();
    for (int i = 1; i < len; i++) {
@@ -461,28 +3386,131 @@ Lexicon::Edge *Lexicon::traceToLastEdge(const std::string & s) const {
    return curEdge;
 }
 
-bool Lexicon::containsPrefix(std::string prefix) const {
+/*
+ * Implementation notes: contains, containsPrefix
+ * ----------------------------------------------
+ * Tracing through the DAWG ignores case, because charToOrd lowercases
+ * each character, so the argument is only converted to lowercase (see
+ * lowercaseView) when it must be compared with otherWords.
+ */
+
+bool Lexicon::containsPrefix(std::string_view prefix) const {
+   WCLIB_INSTRUMENT_SCOPE("Lexicon::containsPrefix");
    if (prefix.empty()) return true;
-   toLowerCaseInPlace(prefix);
    if (traceToLastEdge(prefix)) return true;
-   for (std::string word : otherWords) {
-      if (startsWith(word, prefix)) return true;
-      if (prefix < word) return false;
-   }
-   return false;
+   return otherWordsContainPrefix(prefix);
 }
 
-bool Lexicon::contains(std::string word) const {
-   toLowerCaseInPlace(word);
+bool Lexicon::otherWordsContainPrefix(std::string_view prefix) const {
+   if (otherWords.empty()) return false;
+   std::string storage;
+   prefix = lowercaseView(prefix, storage);
+   auto pos = otherWords.lower_bound(prefix);
+   return pos != otherWords.end() && startsWith(*pos, prefix);
+}
+
+bool Lexicon::contains(std::string_view word) const {
+   WCLIB_INSTRUMENT_SCOPE("Lexicon::contains");
    Edge *lastEdge = traceToLastEdge(word);
    if (lastEdge && lastEdge->accept) return true;
-   return otherWords.find(word) != otherWords.end();
+   return otherWordsContain(word);
+}
+
+bool Lexicon::otherWordsContain(std::string_view word) const {
+   if (otherWords.empty()) return false;
+   std::string storage;
+   return otherWords.find(lowercaseView(word, storage)) != otherWords.end();
+}
+
+/*
+ * Implementation notes: containsBatch, containsPrefixBatch
+ * --------------------------------------------------------
+ * A single lookup spends most of its time waiting for the next node of
+ * the DAWG to arrive from memory.  The batch versions trace a group of
+ * words at once, advancing each one by a single letter per round and
+ * prefetching the node it will visit next, so the memory accesses of
+ * the different words overlap instead of happening one after another.
+ * Words that fall off the DAWG are then checked against otherWords.
+ */
+
+void Lexicon::traceBatch(const std::string_view *words, int count,
+                         bool *results, bool prefixes) const {
+   const int GROUP_SIZE = 16;
+   Edge *node[GROUP_SIZE];
+   Edge *found[GROUP_SIZE];
+   size_t depth[GROUP_SIZE];
+   for (int base = 0; base < count; base += GROUP_SIZE) {
+      int n = std::min(GROUP_SIZE, count - base);
+      const std::string_view *group = words + base;
+      bool pending = false;
+      for (int i = 0; i < n; i++) {
+         node[i] = group[i].empty() ? NULL : start;
+         found[i] = NULL;
+         depth[i] = 0;
+         pending |= (node[i] != NULL);
+      }
+      while (pending) {
+         pending = false;
+         for (int i = 0; i < n; i++) {
+            if (node[i] == NULL) continue;
+            Edge *ep = findEdgeForChar(node[i], group[i][depth[i]]);
+            depth[i]++;
+            if (ep == NULL) {
+               node[i] = NULL;
+            } else if (depth[i] == group[i].length()) {
+               found[i] = ep;
+               node[i] = NULL;
+            } else if (ep->children == 0) {
+               node[i] = NULL;
+            } else {
+               node[i] = &edges[ep->children];
+               prefetch(node[i]);
+               if (!childMasks.empty()) prefetch(&childMasks[ep->children]);
+               pending = true;
+            }
+         }
+      }
+      for (int i = 0; i < n; i++) {
+         if (prefixes) {
+            results[base + i] = group[i].empty() || found[i] != NULL
+                                || otherWordsContainPrefix(group[i]);
+         } else {
+            results[base + i] = (found[i] != NULL && found[i]->accept)
+                                || otherWordsContain(group[i]);
+         }
+      }
+   }
+}
+
+void Lexicon::containsBatch(const std::string_view *words, int count,
+                            bool *results) const {
+   WCLIB_INSTRUMENT_SCOPE("Lexicon::containsBatch");
+   traceBatch(words, count, results, false);
+}
+
+std::vector<bool> Lexicon::containsBatch(const std::vector<std::string_view>& words) const {
+   std::unique_ptr<bool[]> results(new bool[words.size()]);
+   traceBatch(words.data(), words.size(), results.get(), false);
+   return std::vector<bool>(results.get(), results.get() + words.size());
+}
+
+void Lexicon::containsPrefixBatch(const std::string_view *prefixes, int count,
+                                  bool *results) const {
+   WCLIB_INSTRUMENT_SCOPE("Lexicon::containsPrefixBatch");
+   traceBatch(prefixes, count, results, true);
+}
+
+std::vector<bool> Lexicon::containsPrefixBatch(const std::vector<std::string_view>& prefixes) const {
+   std::unique_ptr<bool[]> results(new bool[prefixes.size()]);
+   traceBatch(prefixes.data(), prefixes.size(), results.get(), true);
+   return std::vector<bool>(results.get(), results.get() + prefixes.size());
 }
 
 void Lexicon::add(std::string word) {
+   WCLIB_INSTRUMENT_SCOPE("Lexicon::add");
    toLowerCaseInPlace(word);
    if (!contains(word)) {
-      otherWords.insert(word);
+      otherWords.insert(internWord(word));
    }
 }
 
@@ -492,7 +3520,7 @@ Lexicon::Lexicon(const Lexicon & src) {
 
 Lexicon & Lexicon::operator=(const Lexicon & src) {
    if (this != &src) {
-      if (edges != NULL) delete[] edges;
+      releaseEdges();
       deepCopy(src);
    }
    return *this;
@@ -507,9 +3535,12 @@ bool Lexicon::operator !=(const Lexicon& lex2) const {
 }
 
 void Lexicon::deepCopy(const Lexicon & src) {
+   mappedData = NULL;
+   mappedSize = 0;
    if (src.edges == NULL) {
       edges = NULL;
       start = NULL;
+      numEdges = 0;
    } else {
       numEdges = src.numEdges;
       edges = new Edge[src.numEdges];
@@ -517,19 +3548,236 @@ void Lexicon::deepCopy(const Lexicon & src) {
       start = edges + (src.start - src.edges);
    }
    numDawgWords = src.numDawgWords;
-   otherWords = src.otherWords;
+   clearOtherWords();
+   for (std::string_view word : src.otherWords) {
+      otherWords.emplace_hint(otherWords.end(), internWord(word));
+   }
+   childIndexEnabled = src.childIndexEnabled;
+   childMasks = src.childMasks;
+   if (src.rankIndexReady.load(std::memory_order_acquire)) {
+      wordsThrough = src.wordsThrough;
+      rankIndexReady.store(true, std::memory_order_relaxed);
+   } else {
+      rankIndexReady.store(false, std::memory_order_relaxed);
+   }
 }
 
 void Lexicon::mapAll(void (*fn)(std::string)) const {
-   for (std::string word : *this) {
-      fn(word);
-   }
+   forEachWord([fn](std::string_view word) {
+      fn(std::string(word));
+   });
 }
 
 void Lexicon::mapAll(void (*fn)(const std::string &)) const {
-   for (std::string word : *this) {
+   std::string word;
+   forEachWord([fn, &word](std::string_view view) {
+      word.assign(view.data(), view.length());
       fn(word);
+   });
+}
+
+Lexicon::WordCursor::WordCursor(const Lexicon *lp) {
+   this->lp = lp;
+   pattern = NULL;
+   init("");
+}
+
+Lexicon::WordCursor::WordCursor(const Lexicon *lp, std::string_view prefix) {
+   this->lp = lp;
+   pattern = NULL;
+   init(prefix);
+}
+
+Lexicon::WordCursor::WordCursor(const Lexicon *lp, const WordPattern *pattern) {
+   this->lp = lp;
+   this->pattern = pattern;
+   init(pattern->literalPrefix());
+}
+
+/*
+ * Implementation notes: WordCursor::init
+ * --------------------------------------
+ * For a nonempty prefix the traversal starts at the edge for its last
+ * letter, which stays at the bottom of the path so that the traversal
+ * only covers the words below it.  The extra words sharing the prefix
+ * form a contiguous range of the set, which starts at lower_bound.
+ */
+
+void Lexicon::WordCursor::init(std::string_view prefix) {
+   this->prefix = toLowerCase(prefix);
+   root = lp->start;
+   fixedEdges = 0;
+   if (!this->prefix.empty()) {
+      root = lp->traceToLastEdge(this->prefix);
+      fixedEdges = 1;
+      dawgWord.assign(this->prefix, 0, this->prefix.length() - 1);
+   }
+   baseStates = 0;
+   if (pattern != NULL) {
+      baseStates = pattern->initialStates();
+      for (char ch : dawgWord) {
+         baseStates = pattern->step(baseStates, ch);
+      }
+   }
+   dawgStarted = false;
+   dawgValid = advanceDawg();
+   setIterator = lp->otherWords.lower_bound(this->prefix);
+   skipUnmatchedSetWords();
+   consumed = FROM_NEITHER;
+}
+
+/*
+ * Implementation notes: WordCursor::advanceDawg
+ * ---------------------------------------------
+ * Moves to the next edge in depth-first order, descending to the first
+ * child when there is one and otherwise to the next sibling of the
+ * nearest edge on the path that has one, until reaching an edge that
+ * accepts.  Edges after which the pattern can no longer match are
+ * treated as though they had no children.  Returns false when the
+ * DAWG is exhausted.
+ */
+
+bool Lexicon::WordCursor::advanceDawg() {
+   bool descend = true;
+   while (true) {
+      if (!dawgStarted) {
+         dawgStarted = true;
+         if (root == NULL) return false;
+         path.push_back(root);
+         dawgWord.push_back(lp->ordToChar(root->letter));
+      } else if (descend && path.back()->children != 0) {
+         Edge *child = &lp->edges[path.back()->children];
+         path.push_back(child);
+         dawgWord.push_back(lp->ordToChar(child->letter));
+      } else {
+         while (path.size() > fixedEdges && path.back()->lastEdge) {
+            path.pop_back();
+            dawgWord.pop_back();
+         }
+         if (path.size() <= fixedEdges) return false;
+         path.back()++;
+         dawgWord.back() = lp->ordToChar(path.back()->letter);
+      }
+      descend = topCanMatch();
+      if (descend && path.back()->accept
+                  && (pattern == NULL || pattern->accepts(states.back()))) {
+         return true;
+      }
+   }
+}
+
+/*
+ * Updates the pattern states for the edge at the top of the path and
+ * reports whether any word below that edge could still match.
+ */
+
+bool Lexicon::WordCursor::topCanMatch() {
+   if (pattern == NULL) return true;
+   states.resize(path.size());
+   WordPattern::StateSet parent = (path.size() >= 2) ? states[path.size() - 2]
+                                                     : baseStates;
+   states.back() = pattern->step(parent, dawgWord.back());
+   return states.back() != 0;
+}
+
+void Lexicon::WordCursor::skipUnmatchedSetWords() {
+   while (setIterator != lp->otherWords.end()) {
+      if (!startsWith(*setIterator, prefix)) {
+         setIterator = lp->otherWords.end();
+         return;
+      }
+      if (pattern == NULL || pattern->matches(*setIterator)) return;
+      ++setIterator;
+   }
+}
+
+/*
+ * Implementation notes: WordCursor::next
+ * --------------------------------------
+ * The word returned by the previous call must stay intact until the
+ * caller is done with it, so the source it came from is advanced at
+ * the start of the following call rather than at the end of this one.
+ */
+
+bool Lexicon::WordCursor::next(std::string_view& word) {
+   if (consumed == FROM_DAWG) {
+      dawgValid = advanceDawg();
+   } else if (consumed == FROM_SET) {
+      ++setIterator;
+      skipUnmatchedSetWords();
+   }
+   bool setValid = setIterator != lp->otherWords.end();
+   if (dawgValid && (!setValid || std::string_view(dawgWord) < *setIterator)) {
+      word = dawgWord;
+      consumed = FROM_DAWG;
+   } else if (setValid) {
+      word = *setIterator;
+      consumed = FROM_SET;
+   } else {
+      consumed = FROM_NEITHER;
+      return false;
+   }
+   return true;
+}
+
+/*
+ * Implementation notes: WordPattern
+ * ---------------------------------
+ * A state on a star stays active on any character and also activates
+ * the state after the star without consuming one, which closure adds.
+ * A state on any other character advances when the character matches,
+ * which is a shift of the states selected by that character's mask.
+ */
+
+Lexicon::WordPattern::WordPattern(std::string_view pattern) {
+   if (pattern.length() > size_t(MAX_PATTERN_LENGTH)) {
+      error("Lexicon::forEachMatch: pattern is too long");
+   }
+   std::string lower = toLowerCase(pattern);
+   memset(letterMasks, 0, sizeof letterMasks);
+   starMask = 0;
+   for (size_t i = 0; i < lower.length(); i++) {
+      StateSet bit = StateSet(1) << i;
+      if (lower[i] == '*') {
+         starMask |= bit;
+      } else if (lower[i] == '?') {
+         for (StateSet& mask : letterMasks) mask |= bit;
+      } else {
+         letterMasks[(unsigned char) lower[i]] |= bit;
+      }
+   }
+   acceptMask = StateSet(1) << lower.length();
+   prefix = lower.substr(0, lower.find_first_of("?*"));
+}
+
+Lexicon::WordPattern::StateSet Lexicon::WordPattern::closure(StateSet states) const {
+   StateSet next;
+   while ((next = states | ((states & starMask) << 1)) != states) {
+      states = next;
+   }
+   return states;
+}
+
+Lexicon::WordPattern::StateSet Lexicon::WordPattern::initialStates() const {
+   return closure(1);
+}
+
+Lexicon::WordPattern::StateSet Lexicon::WordPattern::step(StateSet states, char ch) const {
+   return closure(((states & letterMasks[(unsigned char) ch]) << 1)
+                  | (states & starMask));
+}
+
+bool Lexicon::WordPattern::accepts(StateSet states) const {
+   return (states & acceptMask) != 0;
+}
+
+bool Lexicon::WordPattern::matches(std::string_view word) const {
+   StateSet states = initialStates();
+   for (char ch : word) {
+      states = step(states, ch);
+      if (states == 0) return false;
    }
+   return accepts(states);
 }
 
 void Lexicon::iterator::advanceToNextWordInSet() {
@@ -583,23 +3831,246 @@ void Lexicon::iterator::advanceToNextEdge() {
 std::ostream & operator<<(std::ostream & os, const Lexicon & lex) {
    os << "{";
    bool started = false;
-   for (std::string s : lex) {
+   lex.forEachWord([&os, &started](std::string_view s) {
       if (started) os << ", ";
       os << s;
       started = true;
-   }
+   });
    os << "}";
    return os;
 }
 
+/*
+ * Hash function for strings.  Arithmetic is unsigned so that
+ * overflow wraps instead of being undefined.
+ */
+
+static unsigned hashWord(std::string_view str) {
+    unsigned hash = HASH_SEED;
+    for (char ch : str) {
+        hash = HASH_MULTIPLIER * hash + ch;
+    }
+    return hash;
+}
+
+int hashCode(const std::string& str) {
+    return int(hashWord(str) & HASH_MASK);
+}
+
 /*
  * Hash function for lexicons.
  */
 
 int hashCode(const Lexicon& l) {
-    int code = HASH_SEED;
-    for (std::string n : l) {
-        code = HASH_MULTIPLIER * code + hashCode(n);
-    }
+    unsigned code = HASH_SEED;
+    l.forEachWord([&code](std::string_view n) {
+        code = HASH_MULTIPLIER * code + (hashWord(n) & HASH_MASK);
+    });
     return int(code & HASH_MASK);
-}
\ No newline at end of file
+}
+/*
+ * Implementation notes: LexiconSnapshot
+ * -------------------------------------
+ * The snapshot keeps its DAWG in an ordinary Lexicon whose otherWords
+ * set is empty, so the DAWG lookups are the shared const ones.  None of
+ * those touch mutable state: the rank index, the only part built on
+ * demand, is not reachable from a snapshot.  The extra words live in a
+ * sorted vector, which is searched with a binary search.
+ */
+
+LexiconSnapshot::LexiconSnapshot(const Lexicon& lex) : dawg(lex) {
+   extraWords.assign(dawg.otherWords.begin(), dawg.otherWords.end());
+   dawg.clearOtherWords();
+}
+
+bool LexiconSnapshot::contains(std::string_view word) const {
+   WCLIB_INSTRUMENT_SCOPE("LexiconSnapshot::contains");
+   Lexicon::Edge *lastEdge = dawg.traceToLastEdge(word);
+   if (lastEdge && lastEdge->accept) return true;
+   return extraWordsContain(word);
+}
+
+bool LexiconSnapshot::containsPrefix(std::string_view prefix) const {
+   WCLIB_INSTRUMENT_SCOPE("LexiconSnapshot::containsPrefix");
+   if (prefix.empty() || dawg.traceToLastEdge(prefix)) return true;
+   return extraWordsContainPrefix(prefix);
+}
+
+void LexiconSnapshot::containsBatch(const std::string_view *words, int count,
+                                    bool *results) const {
+   dawg.traceBatch(words, count, results, false);
+   if (extraWords.empty()) return;
+   for (int i = 0; i < count; i++) {
+      if (!results[i]) results[i] = extraWordsContain(words[i]);
+   }
+}
+
+int LexiconSnapshot::size() const {
+   return dawg.numDawgWords + extraWords.size();
+}
+
+bool LexiconSnapshot::isEmpty() const {
+   return size() == 0;
+}
+
+bool LexiconSnapshot::extraWordsContain(std::string_view word) const {
+   if (extraWords.empty()) return false;
+   std::string storage;
+   word = lowercaseView(word, storage);
+   auto pos = std::lower_bound(extraWords.begin(), extraWords.end(), word,
+                               std::less<>());
+   return pos != extraWords.end() && *pos == word;
+}
+
+bool LexiconSnapshot::extraWordsContainPrefix(std::string_view prefix) const {
+   if (extraWords.empty()) return false;
+   std::string storage;
+   prefix = lowercaseView(prefix, storage);
+   auto pos = std::lower_bound(extraWords.begin(), extraWords.end(), prefix,
+                               std::less<>());
+   return pos != extraWords.end() && startsWith(*pos, prefix);
+}
+
+/*
+ * Implementation notes: SharedLexicon
+ * -----------------------------------
+ * The current snapshot is swapped with the atomic shared_ptr functions,
+ * and publishedVersion is bumped after each swap.  A reader that sees
+ * a new version reloads the pointer, which gives it that snapshot or a
+ * newer one; a reader that sees the old version keeps its cached
+ * snapshot, which is still a consistent lexicon.  Either way the
+ * common path is a single load of a counter that is written only when
+ * a snapshot is published.
+ */
+
+SharedLexicon::SharedLexicon()
+   : SharedLexicon(std::make_shared<LexiconSnapshot>(Lexicon())) {
+   /* Empty */
+}
+
+SharedLexicon::SharedLexicon(std::shared_ptr<const LexiconSnapshot> snapshot)
+   : current(std::move(snapshot)), publishedVersion(0) {
+   if (!current) error("SharedLexicon: snapshot must not be null");
+}
+
+std::shared_ptr<const LexiconSnapshot> SharedLexicon::load() const {
+   return std::atomic_load_explicit(&current, std::memory_order_acquire);
+}
+
+void SharedLexicon::publish(std::shared_ptr<const LexiconSnapshot> snapshot) {
+   if (!snapshot) error("SharedLexicon::publish: snapshot must not be null");
+   std::atomic_store_explicit(&current, std::move(snapshot),
+                              std::memory_order_release);
+   publishedVersion.fetch_add(1, std::memory_order_release);
+}
+
+uint64_t SharedLexicon::version() const {
+   return publishedVersion.load(std::memory_order_acquire);
+}
+
+SharedLexicon::Reader::Reader(const SharedLexicon& source) {
+   this->source = &source;
+   seenVersion = source.version();
+   cached = source.load();
+}
+
+const LexiconSnapshot& SharedLexicon::Reader::get() {
+   uint64_t version = source->version();
+   if (version != seenVersion) {
+      seenVersion = version;
+      cached = source->load();
+   }
+   return *cached;
+}
+
+/*
+ * Implementation notes: hashBytes
+ * -------------------------------
+ * This is the XXH64 algorithm.  Inputs of 32 bytes or more are consumed
+ * in four independent lanes of 8 bytes each, which keeps several
+ * multiplications in flight at once; the lanes are then merged and the
+ * remaining bytes mixed in one at a time.
+ */
+
+namespace {
+   const uint64_t XXH_PRIME1 = 11400714785074694791ULL;
+   const uint64_t XXH_PRIME2 = 14029467366897019727ULL;
+   const uint64_t XXH_PRIME3 = 1609587929392839161ULL;
+   const uint64_t XXH_PRIME4 = 9650029242287828579ULL;
+   const uint64_t XXH_PRIME5 = 2870177450012600261ULL;
+
+   inline uint64_t rotateLeft(uint64_t x, int bits) {
+      return (x << bits) | (x >> (64 - bits));
+   }
+
+   inline uint64_t read64(const unsigned char *p) {
+      uint64_t value;
+      memcpy(&value, p, sizeof value);
+      return value;
+   }
+
+   inline uint32_t read32(const unsigned char *p) {
+      uint32_t value;
+      memcpy(&value, p, sizeof value);
+      return value;
+   }
+
+   inline uint64_t xxhRound(uint64_t acc, uint64_t input) {
+      acc += input * XXH_PRIME2;
+      acc = rotateLeft(acc, 31);
+      return acc * XXH_PRIME1;
+   }
+
+   inline uint64_t xxhMerge(uint64_t acc, uint64_t lane) {
+      acc ^= xxhRound(0, lane);
+      return acc * XXH_PRIME1 + XXH_PRIME4;
+   }
+}
+
+uint64_t hashBytes(const void *data, size_t length, uint64_t seed) {
+   const unsigned char *p = static_cast<const unsigned char *>(data);
+   const unsigned char *end = p + length;
+   uint64_t hash;
+   if (length >= 32) {
+      uint64_t v1 = seed + XXH_PRIME1 + XXH_PRIME2;
+      uint64_t v2 = seed + XXH_PRIME2;
+      uint64_t v3 = seed;
+      uint64_t v4 = seed - XXH_PRIME1;
+      const unsigned char *limit = end - 32;
+      do {
+         v1 = xxhRound(v1, read64(p));
+         v2 = xxhRound(v2, read64(p + 8));
+         v3 = xxhRound(v3, read64(p + 16));
+         v4 = xxhRound(v4, read64(p + 24));
+         p += 32;
+      } while (p <= limit);
+      hash = rotateLeft(v1, 1) + rotateLeft(v2, 7)
+           + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+      hash = xxhMerge(hash, v1);
+      hash = xxhMerge(hash, v2);
+      hash = xxhMerge(hash, v3);
+      hash = xxhMerge(hash, v4);
+   } else {
+      hash = seed + XXH_PRIME5;
+   }
+   hash += length;
+   for (; p + 8 <= end; p += 8) {
+      hash ^= xxhRound(0, read64(p));
+      hash = rotateLeft(hash, 27) * XXH_PRIME1 + XXH_PRIME4;
+   }
+   if (p + 4 <= end) {
+      hash ^= uint64_t(read32(p)) * XXH_PRIME1;
+      hash = rotateLeft(hash, 23) * XXH_PRIME2 + XXH_PRIME3;
+      p += 4;
+   }
+   for (; p < end; p++) {
+      hash ^= *p * XXH_PRIME5;
+      hash = rotateLeft(hash, 11) * XXH_PRIME1;
+   }
+   hash ^= hash >> 33;
+   hash *= XXH_PRIME2;
+   hash ^= hash >> 29;
+   hash *= XXH_PRIME3;
+   hash ^= hash >> 32;
+   return hash;
+}
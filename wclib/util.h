@@ -72,10 +72,188 @@ void error(std::string msg);
  */
 void pause_ms(int millis);
 
+// Instrumentation ----------------------------------------------
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * Instrumentation
+ * ---------------
+ * When the library is compiled with WCLIB_INSTRUMENT defined, the
+ * string helpers, the Lexicon load and lookup methods and the Grid
+ * bulk operations count their calls, the time spent in them and the
+ * heap allocations they make.  The figures for a call include those of
+ * any instrumented function it calls.  Time is measured in ticks,
+ * which are processor cycles on x86 and nanoseconds elsewhere.
+ *
+ * Allocations are counted by a replacement for the global operator
+ * new in util.cpp.  A program that replaces operator new itself should
+ * also define WCLIB_INSTRUMENT_NO_NEW and call
+ * instrumentRecordAllocation from its own version.
+ *
+ * Without WCLIB_INSTRUMENT the hooks compile to nothing, and the
+ * functions below report no data.
+ */
+
+/**
+ * The figures recorded for one instrumented function.
+ */
+struct InstrumentSample {
+   std::string name;
+   uint64_t calls;
+   uint64_t ticks;
+   uint64_t allocations;
+   uint64_t allocatedBytes;
+};
+
+/**
+ * Returns the figures for every instrumented function that has been
+ * called, in alphabetical order of name.
+ */
+std::vector<InstrumentSample> instrumentSnapshot();
+
+/**
+ * Sets all the recorded figures back to zero.
+ */
+void instrumentReset();
+
+/**
+ * Returns the current figures in the Prometheus text exposition
+ * format or as a JSON object.
+ *
+ * Sample usages:
+ *
+ *     cout << instrumentToPrometheus();
+ *     cout << instrumentToJson();
+ */
+std::string instrumentToPrometheus();
+std::string instrumentToJson();
+
+/**
+ * Records an allocation of the specified size made by the current
+ * thread.
+ */
+void instrumentRecordAllocation(size_t size);
+
+#ifdef WCLIB_INSTRUMENT
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+/*
+ * Private class: InstrumentCounter
+ * --------------------------------
+ * The figures for one instrumented function, held in a static
+ * variable inside the function and linked into a global list the
+ * first time the function runs.
+ */
+class InstrumentCounter {
+public:
+   explicit InstrumentCounter(const char *name);
+
+   const char *name;
+   std::atomic<uint64_t> calls;
+   std::atomic<uint64_t> ticks;
+   std::atomic<uint64_t> allocations;
+   std::atomic<uint64_t> allocatedBytes;
+   InstrumentCounter *next;
+};
+
+/* Allocations made so far by the current thread */
+struct InstrumentThreadCounts {
+   uint64_t allocations;
+   uint64_t allocatedBytes;
+};
+
+extern thread_local InstrumentThreadCounts instrumentThreadCounts;
+
+inline uint64_t instrumentTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+   return __rdtsc();
+#else
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/*
+ * Private class: InstrumentScope
+ * ------------------------------
+ * Adds the time and allocations between its construction and its
+ * destruction to a counter.
+ */
+class InstrumentScope {
+public:
+   explicit InstrumentScope(InstrumentCounter& counter) : counter(counter) {
+      startAllocations = instrumentThreadCounts.allocations;
+      startBytes = instrumentThreadCounts.allocatedBytes;
+      startTicks = instrumentTicks();
+   }
+
+   ~InstrumentScope() {
+      uint64_t elapsed = instrumentTicks() - startTicks;
+      counter.calls.fetch_add(1, std::memory_order_relaxed);
+      counter.ticks.fetch_add(elapsed, std::memory_order_relaxed);
+      counter.allocations.fetch_add(instrumentThreadCounts.allocations - startAllocations,
+                                    std::memory_order_relaxed);
+      counter.allocatedBytes.fetch_add(instrumentThreadCounts.allocatedBytes - startBytes,
+                                       std::memory_order_relaxed);
+   }
+
+private:
+   InstrumentCounter& counter;
+   uint64_t startTicks;
+   uint64_t startAllocations;
+   uint64_t startBytes;
+};
+
+#define WCLIB_INSTRUMENT_SCOPE(name) \
+   static InstrumentCounter wclibInstrumentCounter(name); \
+   InstrumentScope wclibInstrumentScope(wclibInstrumentCounter)
+
+#else
+
+#define WCLIB_INSTRUMENT_SCOPE(name) ((void) 0)
+
+#endif
+
+#if defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+#endif
 #include <string>
+#include <string_view>
+
+/*
+ * String arguments
+ * ----------------
+ * The functions below that only read their string argument take a
+ * std::string_view, so they accept a std::string, a string literal or
+ * a slice of a larger buffer without copying it.
+ *
+ * Where the standard library provides std::pmr (signalled by
+ * __cpp_lib_memory_resource), the functions that return a new string
+ * also have an overload that takes a std::pmr::memory_resource and
+ * returns a std::pmr::string whose storage comes from that resource.
+ * A caller that produces many short-lived strings can then take them
+ * all from an arena and free them at once:
+ *
+ *     std::pmr::monotonic_buffer_resource arena;
+ *     std::pmr::string word = toLowerCase(token, &arena);
+ */
 
 /** \_overload */
-bool startsWith(const std::string& str, const char prefix);
+constexpr bool startsWith(std::string_view str, char prefix) {
+    return str.length() > 0 && str[0] == prefix;
+}
 /**
  * Returns \c true if the string \em str starts with
  * the specified prefix, which may be either a string or a character.
@@ -84,7 +262,26 @@ bool startsWith(const std::string& str, const char prefix);
  *
  *     if (startsWith(str, prefix)) ...
  */
-bool startsWith(const std::string& str, const std::string& prefix);
+constexpr bool startsWith(std::string_view str, std::string_view prefix) {
+    return str.length() >= prefix.length() && str.substr(0, prefix.length()) == prefix;
+}
+
+/** \_overload */
+constexpr bool endsWith(std::string_view str, char suffix) {
+    return str.length() > 0 && str[str.length() - 1] == suffix;
+}
+/**
+ * Returns \c true if the string \em str ends with
+ * the specified suffix, which may be either a string or a character.
+ *
+ * Sample usage:
+ *
+ *     if (endsWith(str, suffix)) ...
+ */
+constexpr bool endsWith(std::string_view str, std::string_view suffix) {
+    return str.length() >= suffix.length()
+        && str.substr(str.length() - suffix.length()) == suffix;
+}
 
 /**
  * Returns a new character in which the given uppercase character has been
@@ -92,71 +289,1253 @@ bool startsWith(const std::string& str, const std::string& prefix);
  */
 char toLowerCase(char ch);
 
-/**
- * Returns a new string in which all uppercase characters have been converted
- * into their lowercase equivalents.
+#if defined(__cpp_lib_memory_resource)
+/** \_overload */
+std::pmr::string toLowerCase(std::string_view str,
+                             std::pmr::memory_resource *resource);
+#endif
+/**
+ * Returns a new string in which all uppercase characters have been converted
+ * into their lowercase equivalents.
+ */
+std::string toLowerCase(std::string_view str);
+
+/**
+ * Writes the characters of \em str, converted to lowercase, into the
+ * buffer \em dst, which must have room for <code>str.length()</code>
+ * characters.  No memory is allocated and no terminating null character
+ * is added.  The buffer may be the source itself.
+ *
+ * Sample usage:
+ *
+ *     toLowerCase(token, buf);
+ */
+void toLowerCase(std::string_view str, char *dst);
+
+/**
+ * Modifies the given string in-place such that all uppercase characters have
+ * been converted into their lowercase equivalents.
+ */
+void toLowerCaseInPlace(std::string& str);
+
+/**
+ * Returns a new character in which the given lowercase character has been
+ * converted into its uppercase equivalent.
+ */
+char toUpperCase(char ch);
+
+#if defined(__cpp_lib_memory_resource)
+/** \_overload */
+std::pmr::string toUpperCase(std::string_view str,
+                             std::pmr::memory_resource *resource);
+#endif
+/**
+ * Returns a new string in which all lowercase characters have been converted
+ * into their uppercase equivalents.
+ */
+std::string toUpperCase(std::string_view str);
+
+/**
+ * Writes the characters of \em str, converted to uppercase, into the
+ * buffer \em dst, which must have room for <code>str.length()</code>
+ * characters.  No memory is allocated and no terminating null character
+ * is added.  The buffer may be the source itself.
+ *
+ * Sample usage:
+ *
+ *     toUpperCase(token, buf);
+ */
+void toUpperCase(std::string_view str, char *dst);
+
+/**
+ * Modifies the given string in-place such that all lowercase characters have
+ * been converted into their uppercase equivalents.
+ */
+void toUpperCaseInPlace(std::string& str);
+
+/**
+ * Returns a copy of the UTF-8 string \em str in which every letter has
+ * been converted to lowercase or to uppercase using the full Unicode
+ * case mappings, so that a result may be longer than its source, as
+ * when <code>"straße"</code> becomes <code>"STRASSE"</code>.  A capital
+ * sigma becomes a final sigma, as in <code>"ΟΔΟΣ"</code> to
+ * <code>"οδος"</code>, when it follows a cased letter and no cased
+ * letter follows it, skipping the case-ignorable characters, such as
+ * apostrophes and accents, on either side.  Bytes that are not
+ * part of valid UTF-8 are copied unchanged.  Runs of ASCII text are
+ * converted by the same kernel as \ref toLowerCase.
+ *
+ * Sample usages:
+ *
+ *     string s = toLowerCaseUtf8(name);
+ *     string s = toUpperCaseUtf8(name);
+ */
+std::string toLowerCaseUtf8(std::string_view str);
+std::string toUpperCaseUtf8(std::string_view str);
+
+/**
+ * Returns a copy of the UTF-8 string \em str in which the first code
+ * point has been converted to titlecase and the rest to lowercase.
+ * Titlecase differs from uppercase for the letters that stand for two
+ * letters, so <code>"ǆungla"</code> becomes <code>"ǅungla"</code>.
+ *
+ * Sample usage:
+ *
+ *     string s = capitalizeUtf8(name);
+ */
+std::string capitalizeUtf8(std::string_view str);
+
+/**
+ * Returns a copy of the UTF-8 string \em str in which the first letter
+ * of each word has been converted to titlecase and the other letters to
+ * lowercase.  A word is a run of letters and digits, which may contain
+ * apostrophes and combining accents, so <code>"o'neill's 3rd"</code>
+ * becomes <code>"O'neill's 3rd"</code>.
+ *
+ * Sample usage:
+ *
+ *     string s = toTitleCaseUtf8(heading);
+ */
+std::string toTitleCaseUtf8(std::string_view str);
+
+#if defined(__cpp_lib_memory_resource)
+/** \_overload */
+std::pmr::string trim(std::string_view str, std::pmr::memory_resource *resource);
+#endif
+/**
+ * Returns a new string after removing any whitespace characters
+ * from the beginning and end of the argument.
+ */
+std::string trim(std::string_view str);
+
+/**
+ * Returns a view of the part of \em str that remains after removing any
+ * whitespace characters from its beginning and end.  No memory is
+ * allocated; the view refers to the characters of \em str.
+ *
+ * Sample usage:
+ *
+ *     string_view field = trimView(line);
+ */
+std::string_view trimView(std::string_view str);
+
+/**
+ * Modifies the given string in-place where any whitespace characters
+ * from the beginning and end of the argument are removed.
+ */
+void trimInPlace(std::string& str);
+
+#if defined(__cpp_lib_memory_resource)
+/** \_overload */
+std::pmr::string trimEnd(std::string_view str, std::pmr::memory_resource *resource);
+#endif
+/**
+ * Returns a new string after removing any whitespace characters
+ * from the end of the argument.
+ */
+std::string trimEnd(std::string_view str);
+
+/**
+ * Returns a view of \em str without any whitespace characters at its
+ * end.  No memory is allocated.
+ */
+std::string_view trimEndView(std::string_view str);
+
+/**
+ * Modifies the given string in-place to remove any whitespace characters
+ * from its end.
+ */
+void trimEndInPlace(std::string& str);
+
+#if defined(__cpp_lib_memory_resource)
+/** \_overload */
+std::pmr::string trimStart(std::string_view str, std::pmr::memory_resource *resource);
+#endif
+/**
+ * Returns a new string after removing any whitespace characters
+ * from the beginning of the argument.
+ */
+std::string trimStart(std::string_view str);
+
+/**
+ * Returns a view of \em str without any whitespace characters at its
+ * beginning.  No memory is allocated.
+ */
+std::string_view trimStartView(std::string_view str);
+
+/**
+ * Modifies the given string in-place to remove removing any whitespace
+ * characters from the beginning of it.
+ */
+void trimStartInPlace(std::string& str);
+
+#include <cstdint>
+
+/**
+ * @class CharClass
+ *
+ * @brief A %CharClass is a precompiled set of characters that can be
+ * tested for membership in constant time.
+ *
+ * The set is stored as a 256-bit table with one bit per byte value, so
+ * building it once and applying it to many strings avoids the cost of
+ * constructing a search structure on every call:
+ *
+ * ~~~
+ *    CharClass vowels("aeiou");
+ *    for (string& line : lines) {
+ *       vowels.removeFromInPlace(line);
+ *    }
+ * ~~~
+ */
+class CharClass {
+public:
+
+/**
+ * Initializes a new character class.  The default constructor creates an
+ * empty class; the second form contains every character of \em chars.
+ *
+ * Sample usages:
+ *
+ *     CharClass cc;
+ *     CharClass cc(chars);
+ */
+   CharClass();
+   CharClass(std::string_view chars);
+
+/**
+ * Adds the given character, or every character of the given string,
+ * to this class.
+ *
+ * Sample usages:
+ *
+ *     cc.add(ch);
+ *     cc.add(chars);
+ */
+   void add(char ch);
+   void add(std::string_view chars);
+
+/**
+ * Returns \c true if \em ch is a member of this class.
+ *
+ * Sample usage:
+ *
+ *     if (cc.contains(ch)) ...
+ */
+   bool contains(char ch) const {
+      unsigned char uc = (unsigned char) ch;
+      return (bits[uc >> 6] >> (uc & 63)) & 1;
+   }
+
+/**
+ * Returns \c true if this class contains no characters.
+ */
+   bool isEmpty() const;
+
+/**
+ * Returns the number of characters of \em str that are members of
+ * this class.
+ */
+   int countIn(std::string_view str) const;
+
+/**
+ * Returns a new string containing the characters of \em str that are
+ * not members of this class, in their original order.  The result
+ * is allocated once, at the size of the input.
+ *
+ * Sample usage:
+ *
+ *     string clean = cc.removeFrom(str);
+ */
+   std::string removeFrom(std::string_view str) const;
+
+#if defined(__cpp_lib_memory_resource)
+/** \_overload */
+   std::pmr::string removeFrom(std::string_view str,
+                               std::pmr::memory_resource *resource) const;
+#endif
+
+/**
+ * Removes every member of this class from \em str in place and
+ * returns the number of characters removed.  No memory is allocated.
+ *
+ * Sample usage:
+ *
+ *     int nRemoved = cc.removeFromInPlace(str);
+ */
+   int removeFromInPlace(std::string& str) const;
+
+private:
+   uint64_t bits[4];   /* One bit for each of the 256 byte values */
+
+   int compact(char *dst, const char *src, int nChars) const;
+};
+
+#include <climits>
+#include <locale>
+#include <type_traits>
+
+/**
+ * @class DigitGrouping
+ *
+ * @brief A %DigitGrouping describes how the integer digits of a number
+ * are separated into groups for display.
+ *
+ * The \em grouping string follows the convention of
+ * <code>std::numpunct::grouping</code>: each character gives the size of
+ * one group, starting from the rightmost digit, and the last size is
+ * repeated for the remaining digits.  The default groups digits in
+ * threes separated by commas, as in <code>1,234,567.89</code>.
+ *
+ * Sample usages:
+ *
+ *     DigitGrouping grouping;
+ *     DigitGrouping grouping('.', ',');
+ *     DigitGrouping grouping(std::locale(""));
+ */
+struct DigitGrouping {
+   char separator;        /* Character inserted between groups    */
+   char decimalPoint;     /* Character written for the '.' in input */
+   std::string grouping;  /* Group sizes, rightmost group first     */
+
+   DigitGrouping(char separator = ',', char decimalPoint = '.',
+                 const std::string& grouping = "\3");
+   DigitGrouping(const std::locale& loc);
+};
+
+/**
+ * The largest number of characters produced by \ref writeWithCommas
+ * for any 64-bit integer under any grouping.
+ */
+static const int MAX_GROUPED_INTEGER_LENGTH = 40;
+
+/**
+ * Returns the number of characters needed to display the 64-bit integer
+ * whose absolute value is \em magnitude with digit separators.
+ */
+int groupedIntegerLength(uint64_t magnitude, bool negative,
+                         const DigitGrouping& grouping = DigitGrouping());
+
+/**
+ * Writes the 64-bit integer whose absolute value is \em magnitude,
+ * with digit separators, into the buffer \em dst.  Exactly
+ * \ref groupedIntegerLength characters are written, back to front,
+ * and no terminating null character is added.  Returns the number of
+ * characters written.
+ */
+int writeGroupedInteger(char *dst, uint64_t magnitude, bool negative,
+                        const DigitGrouping& grouping = DigitGrouping());
+
+/**
+ * Writes the integer \em value with digit separators into the buffer
+ * \em dst, which must have room for \ref MAX_GROUPED_INTEGER_LENGTH
+ * characters, and returns the number of characters written.
+ * No memory is allocated and no terminating null character is added.
+ *
+ * Sample usage:
+ *
+ *     char buf[MAX_GROUPED_INTEGER_LENGTH];
+ *     int len = writeWithCommas(buf, count);
+ */
+template <typename IntType,
+          typename = typename std::enable_if<std::is_integral<IntType>::value>::type>
+int writeWithCommas(char *dst, IntType value,
+                    const DigitGrouping& grouping = DigitGrouping()) {
+   bool negative = value < 0;
+   uint64_t magnitude = negative ? uint64_t(0) - uint64_t(value) : uint64_t(value);
+   return writeGroupedInteger(dst, magnitude, negative, grouping);
+}
+
+/**
+ * Appends the integer \em value with digit separators to the end of
+ * \em out.  The string grows at most once per call.
+ *
+ * Sample usage:
+ *
+ *     appendWithCommas(line, count);
+ */
+template <typename IntType,
+          typename = typename std::enable_if<std::is_integral<IntType>::value>::type>
+void appendWithCommas(std::string& out, IntType value,
+                      const DigitGrouping& grouping = DigitGrouping()) {
+   bool negative = value < 0;
+   uint64_t magnitude = negative ? uint64_t(0) - uint64_t(value) : uint64_t(value);
+   size_t oldLength = out.length();
+   out.resize(oldLength + groupedIntegerLength(magnitude, negative, grouping));
+   writeGroupedInteger(&out[oldLength], magnitude, negative, grouping);
+}
+
+#if defined(__cpp_lib_memory_resource)
+/** \_overload */
+template <typename IntType,
+          typename = typename std::enable_if<std::is_integral<IntType>::value>::type>
+void appendWithCommas(std::pmr::string& out, IntType value,
+                      const DigitGrouping& grouping = DigitGrouping()) {
+   bool negative = value < 0;
+   uint64_t magnitude = negative ? uint64_t(0) - uint64_t(value) : uint64_t(value);
+   size_t oldLength = out.length();
+   out.resize(oldLength + groupedIntegerLength(magnitude, negative, grouping));
+   writeGroupedInteger(&out[oldLength], magnitude, negative, grouping);
+}
+#endif
+
+/**
+ * Appends the decimal number in \em number to the end of \em out with
+ * separators inserted between the groups of its integer digits.  An
+ * optional leading sign is kept, and everything after the integer
+ * digits (such as a fractional part) is copied unchanged except that a
+ * leading '.' becomes the grouping's decimal point.  \em number may
+ * be a view of \em out itself.
+ *
+ * Sample usage:
+ *
+ *     appendWithCommas(line, "-1234567.5");
+ */
+void appendWithCommas(std::string& out, std::string_view number,
+                      const DigitGrouping& grouping = DigitGrouping());
+
+#if defined(__cpp_lib_memory_resource)
+/** \_overload */
+void appendWithCommas(std::pmr::string& out, std::string_view number,
+                      const DigitGrouping& grouping = DigitGrouping());
+#endif
+
+/** \_overload */
+template <typename IntType,
+          typename = typename std::enable_if<std::is_integral<IntType>::value>::type>
+std::string formatWithCommas(IntType value,
+                             const DigitGrouping& grouping = DigitGrouping()) {
+   char buf[MAX_GROUPED_INTEGER_LENGTH];
+   return std::string(buf, writeWithCommas(buf, value, grouping));
+}
+#if defined(__cpp_lib_memory_resource)
+/** \_overload */
+template <typename IntType,
+          typename = typename std::enable_if<std::is_integral<IntType>::value>::type>
+std::pmr::string formatWithCommas(IntType value, std::pmr::memory_resource *resource,
+                                  const DigitGrouping& grouping = DigitGrouping()) {
+   char buf[MAX_GROUPED_INTEGER_LENGTH];
+   return std::pmr::string(buf, writeWithCommas(buf, value, grouping), resource);
+}
+/** \_overload */
+std::pmr::string formatWithCommas(const std::string& number,
+                                  std::pmr::memory_resource *resource,
+                                  const DigitGrouping& grouping = DigitGrouping());
+#endif
+/**
+ * Returns a new string in which the integer digits of the given number
+ * are separated into groups, as in <code>12,345,678</code>.  The result
+ * is allocated once, at its final length.
+ *
+ * Sample usages:
+ *
+ *     string s = formatWithCommas(1234567);
+ *     string s = formatWithCommas("1234567.25");
+ */
+std::string formatWithCommas(const std::string& number,
+                             const DigitGrouping& grouping = DigitGrouping());
+
+class StringBatch;
+
+/**
+ * @class StringPipeline
+ *
+ * @brief A %StringPipeline is a chain of string transformations that is
+ * applied in a single pass over its input.
+ *
+ * The stages are added with the builder methods, each of which returns
+ * the pipeline so that the calls can be chained, and \ref build compiles
+ * them.  Consecutive character stages are folded into one 256-entry
+ * table, and the positional stages (trimming and capitalizing) only need
+ * individual attention until the first character that gets past them,
+ * so each output character is written once into a buffer allocated at
+ * its final size:
+ *
+ * ~~~
+ *    StringPipeline clean = StringPipeline().trim().lower().remove("aeiou").build();
+ *    for (string& line : lines) {
+ *       line = clean.apply(line);
+ *    }
+ * ~~~
+ *
+ * The builder methods are \c constexpr, so a pipeline whose stages are
+ * known when the program is compiled can be built into a constant:
+ *
+ *     static constexpr StringPipeline clean =
+ *        StringPipeline().trim().lower().remove("aeiou").build();
+ *
+ * The stages work on bytes.  Case conversion affects only the ASCII
+ * letters, and whitespace means the characters recognized by
+ * \c isspace in the "C" locale.
+ */
+class StringPipeline {
+public:
+
+/**
+ * The largest number of stages a pipeline can hold.  \ref trim counts
+ * as two stages.
+ */
+   static const int MAX_STAGES = 16;
+
+/**
+ * Initializes a new pipeline with no stages, which copies its input.
+ */
+   constexpr StringPipeline() {}
+
+/**
+ * Adds a stage that removes whitespace from both ends, from the
+ * beginning only, or from the end only of the string it receives.
+ */
+   constexpr StringPipeline& trim() {
+      return trimEnd().trimStart();
+   }
+   constexpr StringPipeline& trimStart() {
+      return addStage(TRIM_START);
+   }
+   constexpr StringPipeline& trimEnd() {
+      return addStage(TRIM_END);
+   }
+
+/**
+ * Adds a stage that converts every letter to lowercase or to uppercase.
+ */
+   constexpr StringPipeline& lower() {
+      return addStage(LOWER);
+   }
+   constexpr StringPipeline& upper() {
+      return addStage(UPPER);
+   }
+
+/**
+ * Adds a stage that converts the first character to uppercase and the
+ * rest to lowercase.
+ */
+   constexpr StringPipeline& capitalize() {
+      return addStage(CAPITALIZE);
+   }
+
+/**
+ * Adds a stage that removes every occurrence of the characters in
+ * \em chars.
+ */
+   constexpr StringPipeline& remove(std::string_view chars) {
+      addStage(REMOVE);
+      for (char ch : chars) {
+         setBit(stages[nStages - 1].chars, (unsigned char) ch);
+      }
+      return *this;
+   }
+
+/**
+ * Adds a final stage that separates the integer digits of the result
+ * into groups, in the same way as \ref formatWithCommas.  The group
+ * sizes are given rightmost group first, as in \ref DigitGrouping.
+ * No stage may follow this one.
+ */
+   constexpr StringPipeline& group(char separator = ',', char decimalPoint = '.',
+                                   std::string_view sizes = "\3") {
+      if (grouped) error("StringPipeline::group: the pipeline is already grouped");
+      if (sizes.length() > sizeof groupSizes) {
+         error("StringPipeline::group: too many group sizes");
+      }
+      grouped = true;
+      compiled = false;
+      groupSeparator = separator;
+      groupDecimalPoint = decimalPoint;
+      nGroupSizes = sizes.length();
+      for (int i = 0; i < nGroupSizes; i++) {
+         groupSizes[i] = sizes[i];
+      }
+      return *this;
+   }
+   StringPipeline& group(const DigitGrouping& grouping) {
+      return group(grouping.separator, grouping.decimalPoint, grouping.grouping);
+   }
+
+/**
+ * Returns a copy of this pipeline that is ready to be applied.  A
+ * pipeline must be built again after any stage is added to it.
+ */
+   constexpr StringPipeline build() const {
+      StringPipeline result = *this;
+      result.compile();
+      return result;
+   }
+
+/**
+ * Returns the result of passing \em str through every stage of this
+ * pipeline.  The second form, where std::pmr is available, allocates
+ * the result from \em resource.
+ */
+   std::string apply(std::string_view str) const;
+#if defined(__cpp_lib_memory_resource)
+   std::pmr::string apply(std::string_view str, std::pmr::memory_resource *resource) const;
+#endif
+
+/**
+ * Writes the result of passing \em str through this pipeline into
+ * \em dst, which must have room for \ref maxLength characters, and
+ * returns the number of characters written.  No memory is allocated
+ * and no terminating null character is added.
+ *
+ * Sample usage:
+ *
+ *     int len = clean.apply(token, buf);
+ */
+   size_t apply(std::string_view str, char *dst) const;
+
+/**
+ * Returns the largest number of characters this pipeline can produce
+ * from an input of the given length.
+ */
+   size_t maxLength(size_t inputLength) const;
+
+/**
+ * Applies this pipeline to every record of a newline-delimited buffer
+ * or of an array of records, using all available processors, and
+ * returns the results in order.  The records are split as described
+ * for \ref transformRecords.
+ *
+ * Sample usage:
+ *
+ *     StringBatch results = clean.applyToRecords(text);
+ */
+   StringBatch applyToRecords(std::string_view text) const;
+   StringBatch applyToRecords(const std::string_view *records, size_t count) const;
+   StringBatch applyToRecords(const std::vector<std::string_view>& records) const;
+
+private:
+   enum StageType : unsigned char {
+      TRIM_START, TRIM_END, LOWER, UPPER, CAPITALIZE, REMOVE
+   };
+
+   struct Stage {
+      StageType type = LOWER;
+      uint64_t chars[4] = {};   /* REMOVE: the characters removed;
+                                   TRIM_END: the input bytes that reach
+                                   this stage as non-whitespace */
+   };
+
+   Stage stages[MAX_STAGES] = {};
+   int nStages = 0;
+   int nPositional = 0;               /* trimStart and capitalize stages */
+   bool compiled = false;
+   bool grouped = false;
+   char groupSeparator = ',';
+   char groupDecimalPoint = '.';
+   char groupSizes[8] = {};
+   int nGroupSizes = 0;
+   unsigned char charMap[256] = {};   /* Each input byte after every stage */
+   unsigned char kept[256] = {};      /* 1 if the byte survives every stage */
+
+   size_t groupInPlace(char *dst, size_t len) const;
+
+   static constexpr bool isSpaceByte(unsigned char ch) {
+      return ch == ' ' || (ch >= '\t' && ch <= '\r');
+   }
+
+   static constexpr unsigned char lowerByte(unsigned char ch) {
+      return (ch >= 'A' && ch <= 'Z') ? ch + ('a' - 'A') : ch;
+   }
+
+   static constexpr unsigned char upperByte(unsigned char ch) {
+      return (ch >= 'a' && ch <= 'z') ? ch - ('a' - 'A') : ch;
+   }
+
+   static constexpr bool testBit(const uint64_t *bits, unsigned char ch) {
+      return (bits[ch >> 6] >> (ch & 63)) & 1;
+   }
+
+   static constexpr void setBit(uint64_t *bits, unsigned char ch) {
+      bits[ch >> 6] |= uint64_t(1) << (ch & 63);
+   }
+
+   constexpr StringPipeline& addStage(StageType type) {
+      if (grouped) error("StringPipeline: no stage may follow group");
+      if (nStages == MAX_STAGES) error("StringPipeline: too many stages");
+      stages[nStages] = Stage();
+      stages[nStages].type = type;
+      nStages++;
+      compiled = false;
+      return *this;
+   }
+
+/*
+ * Computes the tables for the steady state, in which every trimStart
+ * stage has already passed a character and every capitalize stage
+ * lowercases, by running each byte value through the stages.
+ */
+   constexpr void compile() {
+      nPositional = 0;
+      for (int s = 0; s < nStages; s++) {
+         if (stages[s].type == TRIM_END) {
+            for (uint64_t& word : stages[s].chars) word = 0;
+         } else if (stages[s].type == TRIM_START || stages[s].type == CAPITALIZE) {
+            nPositional++;
+         }
+      }
+      for (int c = 0; c < 256; c++) {
+         unsigned char ch = (unsigned char) c;
+         bool alive = true;
+         for (int s = 0; alive && s < nStages; s++) {
+            StageType type = stages[s].type;
+            if (type == LOWER || type == CAPITALIZE) {
+               ch = lowerByte(ch);
+            } else if (type == UPPER) {
+               ch = upperByte(ch);
+            } else if (type == REMOVE) {
+               alive = !testBit(stages[s].chars, ch);
+            } else if (type == TRIM_END && !isSpaceByte(ch)) {
+               setBit(stages[s].chars, (unsigned char) c);
+            }
+         }
+         charMap[c] = ch;
+         kept[c] = alive;
+      }
+      compiled = true;
+   }
+};
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+/**
+ * @class StringBatch
+ *
+ * @brief A %StringBatch holds the results of a bulk string operation
+ * in a single block of text, with an offsets array that marks where
+ * each result begins.  Result \em i consists of the characters from
+ * <code>offsets()[i]</code> up to <code>offsets()[i + 1]</code>.
+ */
+class StringBatch {
+public:
+
+/**
+ * Initializes a batch with no results, or one that holds the given
+ * text and offsets.  The offsets array has one more entry than there
+ * are results, and its last entry is the length of the text.
+ */
+   StringBatch();
+   StringBatch(std::string text, std::vector<size_t> offsets);
+
+/**
+ * Returns the number of results in this batch.
+ */
+   size_t size() const;
+
+/**
+ * Returns \c true if this batch contains no results.
+ */
+   bool isEmpty() const;
+
+/**
+ * Returns a view of the result at the given index, which remains
+ * valid as long as the batch does.  This method signals an error if
+ * the index is out of range.
+ */
+   std::string_view operator[](size_t index) const;
+
+/**
+ * Returns the text that holds every result, one after another, and
+ * the array of offsets into it.
+ */
+   const std::string& text() const;
+   const std::vector<size_t>& offsets() const;
+
+private:
+   std::string allText;
+   std::vector<size_t> bounds;
+};
+
+/**
+ * Applies \em fn to every record and returns the results, in the
+ * order of the records, as a \ref StringBatch.  The function is
+ * called as <code>fn(record, out)</code> and must append its result
+ * for \em record to the string \em out, in the style of
+ * \ref appendWithCommas.
+ *
+ * The first form takes a buffer of records separated by newlines; a
+ * carriage return before a newline is not part of the record, and a
+ * final newline does not start an empty record.  The other forms take
+ * an array of records.  The records are divided into chunks that the
+ * threads claim one at a time, so a thread that draws cheap records
+ * simply takes more chunks.  Because the function is called from
+ * several threads at once, it must be safe to do so.
+ *
+ * Sample usage:
+ *
+ *     StringBatch results = transformRecords(text,
+ *        [](string_view record, string& out) { appendWithCommas(out, record); });
+ */
+template <typename FunctorType>
+StringBatch transformRecords(std::string_view text, FunctorType fn);
+template <typename FunctorType>
+StringBatch transformRecords(const std::string_view *records, size_t count,
+                             FunctorType fn);
+template <typename FunctorType>
+StringBatch transformRecords(const std::vector<std::string_view>& records,
+                             FunctorType fn);
+
+/*
+ * Private functions: record chunks
+ * --------------------------------
+ * runRecordChunks calls fn(chunk, out, ends) once for each chunk on
+ * a set of worker threads; fn appends the results for the records of
+ * the chunk to out and the length of out after each one to ends.  The
+ * chunks are then copied into a single batch in their original order.
+ * recordStart returns the beginning of the first record in text that
+ * starts at or after pos.
+ */
+
+StringBatch runRecordChunks(size_t nChunks,
+                            const std::function<void(size_t chunk, std::string& out,
+                                                     std::vector<size_t>& ends)>& fn);
+size_t recordStart(std::string_view text, size_t pos);
+
+static const size_t RECORD_CHUNK_BYTES = 64 * 1024;   /* Per chunk of a buffer */
+static const size_t RECORD_CHUNK_COUNT = 1024;        /* Per chunk of an array */
+
+template <typename FunctorType>
+StringBatch transformRecords(std::string_view text, FunctorType fn) {
+   size_t nChunks = (text.length() + RECORD_CHUNK_BYTES - 1) / RECORD_CHUNK_BYTES;
+   return runRecordChunks(nChunks, [text, &fn](size_t chunk, std::string& out,
+                                               std::vector<size_t>& ends) {
+      const char *data = text.data();
+      size_t pos = recordStart(text, chunk * RECORD_CHUNK_BYTES);
+      size_t end = recordStart(text, (chunk + 1) * RECORD_CHUNK_BYTES);
+      out.reserve(end - pos);
+      while (pos < end) {
+         const void *newline = memchr(data + pos, '\n', text.length() - pos);
+         size_t finish = (newline == NULL) ? text.length()
+                                           : (const char *) newline - data;
+         std::string_view record(data + pos, finish - pos);
+         if (!record.empty() && record.back() == '\r') record.remove_suffix(1);
+         fn(record, out);
+         ends.push_back(out.length());
+         pos = finish + 1;
+      }
+   });
+}
+
+template <typename FunctorType>
+StringBatch transformRecords(const std::string_view *records, size_t count,
+                             FunctorType fn) {
+   size_t nChunks = (count + RECORD_CHUNK_COUNT - 1) / RECORD_CHUNK_COUNT;
+   return runRecordChunks(nChunks, [records, count, &fn](size_t chunk, std::string& out,
+                                                         std::vector<size_t>& ends) {
+      size_t first = chunk * RECORD_CHUNK_COUNT;
+      size_t last = std::min(count, first + RECORD_CHUNK_COUNT);
+      ends.reserve(last - first);
+      for (size_t i = first; i < last; i++) {
+         fn(records[i], out);
+         ends.push_back(out.length());
+      }
+   });
+}
+
+template <typename FunctorType>
+StringBatch transformRecords(const std::vector<std::string_view>& records,
+                             FunctorType fn) {
+   return transformRecords(records.data(), records.size(), fn);
+}
+
+/*
+ * Compile-time strings
+ * --------------------
+ * The class and functions below are constexpr, so when their input is
+ * a literal the work is done by the compiler and the program contains
+ * only the result:
+ *
+ *     static constexpr auto header = toUpperCase(FixedString("order id"));
+ *     static constexpr auto total = formatWithCommas(FixedString("1234567"));
+ *
+ * Like StringPipeline, they treat characters as bytes, convert only
+ * the ASCII letters, and take whitespace to mean the characters
+ * recognized by isspace in the "C" locale.
+ */
+
+/**
+ * @class FixedString
+ *
+ * @brief A %FixedString holds a string of at most \em N characters in
+ * an array inside the object, followed by a null character.  It never
+ * allocates memory and can be used in constant expressions.  When it
+ * is initialized from a string literal, \em N is deduced as the length
+ * of the literal.
+ */
+template <size_t N>
+class FixedString {
+public:
+
+/**
+ * Initializes an empty string, or a copy of \em str.  The second form
+ * signals an error if \em str is longer than \em N characters.
+ */
+   constexpr FixedString() {}
+   constexpr FixedString(std::string_view str) {
+      append(str);
+   }
+   constexpr FixedString(const char (&str)[N + 1]) {
+      append(std::string_view(str, N));
+   }
+
+/**
+ * Returns the number of characters in this string.
+ */
+   constexpr size_t length() const {
+      return len;
+   }
+   constexpr size_t size() const {
+      return len;
+   }
+
+/**
+ * Returns \c true if this string contains no characters.
+ */
+   constexpr bool isEmpty() const {
+      return len == 0;
+   }
+
+/**
+ * Returns the largest number of characters this string can hold.
+ */
+   static constexpr size_t capacity() {
+      return N;
+   }
+
+/**
+ * Returns the character at the given index, which must be less than
+ * the length of the string.
+ */
+   constexpr char operator[](size_t index) const {
+      return chars[index];
+   }
+   constexpr char& operator[](size_t index) {
+      return chars[index];
+   }
+
+/**
+ * Returns a pointer to the null-terminated characters of this string.
+ */
+   constexpr const char *c_str() const {
+      return chars;
+   }
+
+/**
+ * Returns a view of the characters of this string.  A %FixedString
+ * also converts to a std::string_view wherever one is expected.
+ */
+   constexpr std::string_view view() const {
+      return std::string_view(chars, len);
+   }
+   constexpr operator std::string_view() const {
+      return view();
+   }
+
+/**
+ * Returns a std::string with the same characters.
+ */
+   std::string toString() const {
+      return std::string(chars, len);
+   }
+
+/**
+ * Adds a character or a string to the end of this string, signaling
+ * an error if the result would be longer than \em N characters.
+ */
+   constexpr void append(char ch) {
+      if (len == N) error("FixedString::append: capacity exceeded");
+      chars[len++] = ch;
+   }
+   constexpr void append(std::string_view str) {
+      if (str.length() > N - len) error("FixedString::append: capacity exceeded");
+      for (char ch : str) {
+         chars[len++] = ch;
+      }
+   }
+
+private:
+   char chars[N + 1] = {};
+   size_t len = 0;
+};
+
+template <size_t N>
+FixedString(const char (&str)[N]) -> FixedString<N - 1>;
+
+template <size_t N, size_t M>
+constexpr bool operator==(const FixedString<N>& s1, const FixedString<M>& s2) {
+   return s1.view() == s2.view();
+}
+
+template <size_t N, size_t M>
+constexpr bool operator!=(const FixedString<N>& s1, const FixedString<M>& s2) {
+   return s1.view() != s2.view();
+}
+
+template <size_t N>
+constexpr bool operator==(const FixedString<N>& s1, std::string_view s2) {
+   return s1.view() == s2;
+}
+
+template <size_t N>
+constexpr bool operator!=(const FixedString<N>& s1, std::string_view s2) {
+   return s1.view() != s2;
+}
+
+/*
+ * Private functions: ASCII character tests
+ * ----------------------------------------
+ * The constexpr counterparts of isspace, tolower and toupper in the
+ * "C" locale.
  */
-std::string toLowerCase(const std::string& str);
+
+constexpr bool isAsciiSpace(char ch) {
+   return ch == ' ' || (ch >= '\t' && ch <= '\r');
+}
+
+constexpr char toAsciiLower(char ch) {
+   return (ch >= 'A' && ch <= 'Z') ? char(ch + ('a' - 'A')) : ch;
+}
+
+constexpr char toAsciiUpper(char ch) {
+   return (ch >= 'a' && ch <= 'z') ? char(ch - ('a' - 'A')) : ch;
+}
 
 /**
- * Modifies the given string in-place such that all uppercase characters have
- * been converted into their lowercase equivalents.
+ * Returns a copy of \em str with every letter converted to lowercase
+ * or to uppercase.
  */
-void toLowerCaseInPlace(std::string& str);
+template <size_t N>
+constexpr FixedString<N> toLowerCase(const FixedString<N>& str) {
+   FixedString<N> result;
+   for (char ch : str.view()) {
+      result.append(toAsciiLower(ch));
+   }
+   return result;
+}
+
+template <size_t N>
+constexpr FixedString<N> toUpperCase(const FixedString<N>& str) {
+   FixedString<N> result;
+   for (char ch : str.view()) {
+      result.append(toAsciiUpper(ch));
+   }
+   return result;
+}
 
 /**
- * Returns a new character in which the given lowercase character has been
- * converted into its uppercase equivalent.
+ * Returns a copy of \em str whose first character has been converted
+ * to uppercase and the rest to lowercase.
  */
-char toUpperCase(char ch);
+template <size_t N>
+constexpr FixedString<N> capitalize(const FixedString<N>& str) {
+   FixedString<N> result = toLowerCase(str);
+   if (!result.isEmpty()) result[0] = toAsciiUpper(result[0]);
+   return result;
+}
 
 /**
- * Returns a new string in which all lowercase characters have been converted
- * into their uppercase equivalents.
+ * Returns a copy of \em str without the whitespace at both ends, at
+ * the beginning, or at the end.
  */
-std::string toUpperCase(const std::string& str);
+template <size_t N>
+constexpr FixedString<N> trimStart(const FixedString<N>& str) {
+   std::string_view view = str.view();
+   size_t start = 0;
+   while (start < view.length() && isAsciiSpace(view[start])) start++;
+   return FixedString<N>(view.substr(start));
+}
+
+template <size_t N>
+constexpr FixedString<N> trimEnd(const FixedString<N>& str) {
+   std::string_view view = str.view();
+   size_t finish = view.length();
+   while (finish > 0 && isAsciiSpace(view[finish - 1])) finish--;
+   return FixedString<N>(view.substr(0, finish));
+}
+
+template <size_t N>
+constexpr FixedString<N> trim(const FixedString<N>& str) {
+   return trimStart(trimEnd(str));
+}
 
 /**
- * Modifies the given string in-place such that all lowercase characters have
- * been converted into their uppercase equivalents.
+ * Returns a copy of the decimal number \em number with commas between
+ * the groups of three integer digits, as \ref formatWithCommas does
+ * with the default grouping.
  */
-void toUpperCaseInPlace(std::string& str);
+template <size_t N>
+constexpr FixedString<N + N / 3> formatWithCommas(const FixedString<N>& number) {
+   std::string_view view = number.view();
+   size_t digitsStart = (!view.empty() && (view[0] == '-' || view[0] == '+')) ? 1 : 0;
+   size_t digitsEnd = digitsStart;
+   while (digitsEnd < view.length() && view[digitsEnd] >= '0' && view[digitsEnd] <= '9') {
+      digitsEnd++;
+   }
+   FixedString<N + N / 3> result(view.substr(0, digitsStart));
+   for (size_t i = digitsStart; i < digitsEnd; i++) {
+      if (i > digitsStart && (digitsEnd - i) % 3 == 0) result.append(',');
+      result.append(view[i]);
+   }
+   result.append(view.substr(digitsEnd));
+   return result;
+}
 
 /**
- * Returns a new string after removing any whitespace characters
- * from the beginning and end of the argument.
+ * @class StaticWordSet
+ *
+ * @brief A %StaticWordSet is a fixed set of \em N words, usually built
+ * at compile time from a list of literals, that can be searched in
+ * constant time.
+ *
+ * The set is stored as a perfect hash table: the words are spread over
+ * buckets by one hash function, and each bucket then receives the seed
+ * of a second hash function that places all of its words in empty
+ * slots.  A lookup therefore computes two hashes and compares a single
+ * word.  As in a %Lexicon, words are compared without regard to case.
+ *
+ * ~~~
+ *    static constexpr StaticWordSet keywords({ "select", "from", "where" });
+ *    if (keywords.contains(token)) ...
+ * ~~~
+ *
+ * The words must remain valid as long as the set does, which string
+ * literals always do.  A word that appears more than once is stored
+ * once, under the index of its first occurrence.
  */
-std::string trim(const std::string& str);
+template <size_t N>
+class StaticWordSet {
+public:
 
 /**
- * Modifies the given string in-place where any whitespace characters
- * from the beginning and end of the argument are removed.
+ * Initializes the set from an array of words.  This constructor signals
+ * an error in the unlikely case that no perfect hash is found.
  */
-void trimInPlace(std::string& str);
+   constexpr StaticWordSet(const std::string_view (&list)[N]) {
+      for (size_t i = 0; i < N; i++) {
+         words[i] = list[i];
+      }
+      build();
+   }
 
 /**
- * Returns a new string after removing any whitespace characters
- * from the end of the argument.
+ * Returns \c true if \em word is in the set.
  */
-std::string trimEnd(const std::string& str);
+   constexpr bool contains(std::string_view word) const {
+      return indexOf(word) >= 0;
+   }
 
 /**
- * Modifies the given string in-place to remove any whitespace characters
- * from its end.
+ * Returns the position of \em word in the list the set was built
+ * from, or -1 if it is not in the set.
  */
-void trimEndInPlace(std::string& str);
+   constexpr int indexOf(std::string_view word) const {
+      if (nWords == 0) return -1;
+      uint64_t bucket = hashWord(word, 0) % N_BUCKETS;
+      int index = slots[hashWord(word, seeds[bucket]) & (N_SLOTS - 1)];
+      return (index >= 0 && equalsIgnoringCase(words[index], word)) ? index : -1;
+   }
 
 /**
- * Returns a new string after removing any whitespace characters
- * from the beginning of the argument.
+ * Returns the number of distinct words in the set.
  */
-std::string trimStart(const std::string& str);
+   constexpr size_t size() const {
+      return nWords;
+   }
 
-/**
- * Modifies the given string in-place to remove removing any whitespace
- * characters from the beginning of it.
+private:
+   static constexpr size_t slotCount() {
+      size_t n = 1;
+      while (n < 2 * N) n *= 2;
+      return n;
+   }
+
+   static const size_t N_SLOTS = slotCount();
+   static const size_t N_BUCKETS = N / 2 + 1;
+   static const uint32_t MAX_SEED = 1 << 20;
+
+   std::string_view words[N] = {};
+   int slots[N_SLOTS] = {};
+   uint32_t seeds[N_BUCKETS] = {};
+   size_t nWords = 0;
+
+   static constexpr bool equalsIgnoringCase(std::string_view s1, std::string_view s2) {
+      if (s1.length() != s2.length()) return false;
+      for (size_t i = 0; i < s1.length(); i++) {
+         if (toAsciiLower(s1[i]) != toAsciiLower(s2[i])) return false;
+      }
+      return true;
+   }
+
+   static constexpr uint64_t hashWord(std::string_view word, uint64_t seed) {
+      uint64_t hash = 0xCBF29CE484222325ULL ^ (seed * 0x9E3779B97F4A7C15ULL);
+      for (char ch : word) {
+         hash = (hash ^ (unsigned char) toAsciiLower(ch)) * 0x100000001B3ULL;
+      }
+      hash ^= hash >> 32;
+      hash *= 0xD6E8FEB86659FD93ULL;
+      return hash ^ (hash >> 32);
+   }
+
+/*
+ * Places the buckets with the most words first, since they are the
+ * hardest to fit, trying seeds in turn until every word of the bucket
+ * lands in a distinct empty slot.
  */
-void trimStartInPlace(std::string& str);
+   constexpr void build() {
+      for (int& slot : slots) slot = -1;
+      size_t bucketOf[N] = {};
+      size_t bucketSize[N_BUCKETS] = {};
+      bool duplicate[N] = {};
+      for (size_t i = 0; i < N; i++) {
+         for (size_t j = 0; j < i && !duplicate[i]; j++) {
+            duplicate[i] = !duplicate[j] && equalsIgnoringCase(words[i], words[j]);
+         }
+         if (duplicate[i]) continue;
+         bucketOf[i] = hashWord(words[i], 0) % N_BUCKETS;
+         bucketSize[bucketOf[i]]++;
+         nWords++;
+      }
+      size_t order[N_BUCKETS] = {};
+      for (size_t b = 0; b < N_BUCKETS; b++) {
+         size_t k = b;
+         while (k > 0 && bucketSize[order[k - 1]] < bucketSize[b]) {
+            order[k] = order[k - 1];
+            k--;
+         }
+         order[k] = b;
+      }
+      for (size_t b : order) {
+         if (bucketSize[b] == 0) break;
+         uint32_t seed = 1;
+         while (!placeBucket(b, seed, bucketOf, duplicate)) {
+            if (++seed == MAX_SEED) error("StaticWordSet: no perfect hash found");
+         }
+         seeds[b] = seed;
+      }
+   }
+
+   constexpr bool placeBucket(size_t bucket, uint32_t seed,
+                              const size_t *bucketOf, const bool *duplicate) {
+      for (size_t i = 0; i < N; i++) {
+         if (duplicate[i] || bucketOf[i] != bucket) continue;
+         int& slot = slots[hashWord(words[i], seed) & (N_SLOTS - 1)];
+         if (slot < 0) {
+            slot = int(i);
+            continue;
+         }
+         for (size_t j = 0; j < i; j++) {
+            if (!duplicate[j] && bucketOf[j] == bucket) {
+               slots[hashWord(words[j], seed) & (N_SLOTS - 1)] = -1;
+            }
+         }
+         return false;
+      }
+      return true;
+   }
+};
 
 /**
  * Reads a complete line from the \c cin stream and scans it as an
@@ -198,6 +1577,96 @@ double getReal(std::string prompt = "");
  */
 std::string getLine(std::string prompt = "");
 
+#include <iosfwd>
+#include <vector>
+
+/**
+ * Scans \em text as an integer or a floating-point number, ignoring
+ * whitespace at either end, and returns \c true if the whole string
+ * is a legal value in range.  These functions accept the same input as
+ * \ref getInteger and \ref getReal but never allocate memory.
+ *
+ * Sample usages:
+ *
+ *     if (parseInteger(text, n)) ...
+ *     if (parseReal(text, x)) ...
+ */
+bool parseInteger(std::string_view text, int& value);
+bool parseReal(std::string_view text, double& value);
+
+/**
+ * @class LineReader
+ *
+ * Reads the lines of a stream through a large buffer, without
+ * allocating memory for each line.  Each line is returned as a view
+ * into the buffer, without its terminating newline or a carriage
+ * return before it, and is valid only until the next call to
+ * \ref next.  The reader takes its input directly from the stream's
+ * buffer, reading ahead of the line it returns, so the stream should
+ * not be read by other means while the reader is in use.
+ *
+ * Sample usage:
+ *
+ *     LineReader reader(cin);
+ *     string_view line;
+ *     while (reader.next(line)) ...
+ */
+class LineReader {
+public:
+   static const size_t DEFAULT_BUFFER_SIZE = 1 << 16;
+
+   explicit LineReader(std::istream& in, size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+/**
+ * Stores the next line in \em line and returns \c true, or returns
+ * \c false at the end of the input.
+ */
+   bool next(std::string_view& line);
+
+/**
+ * Returns the number of the line last returned by \ref next,
+ * counting from 1.
+ */
+   long lineNumber() const;
+
+private:
+   std::streambuf *source;
+   std::vector<char> buffer;
+   size_t start;              /* Beginning of the unread text         */
+   size_t scanned;            /* End of the text known to have no \n */
+   size_t end;                /* End of the text read from the source */
+   bool atEnd;
+   long lines;
+};
+
+/**
+ * Specifies what the bulk readers do with a line that is not a legal
+ * value.  <code>BAD_INPUT_ERROR</code> signals an error,
+ * <code>BAD_INPUT_SKIP</code> ignores the line and goes on to the next
+ * one, as \ref getInteger does when it asks the user to try again,
+ * and <code>BAD_INPUT_STOP</code> ends the input at that line.
+ */
+enum BadInputPolicy { BAD_INPUT_ERROR, BAD_INPUT_SKIP, BAD_INPUT_STOP };
+
+/**
+ * Reads a stream containing one value per line, in the format accepted
+ * by \ref getInteger or \ref getReal, and appends the values to
+ * \em values.  The input is read through a \ref LineReader and parsed
+ * with \ref parseInteger or \ref parseReal, so no memory is allocated
+ * for each value beyond the growth of the vector.  Lines that are not
+ * legal values are handled as specified by \em policy.  Returns the
+ * number of values appended.
+ *
+ * Sample usages:
+ *
+ *     readIntegers(cin, numbers);
+ *     readReals(file, samples, BAD_INPUT_SKIP);
+ */
+size_t readIntegers(std::istream& in, std::vector<int>& values,
+                    BadInputPolicy policy = BAD_INPUT_ERROR);
+size_t readReals(std::istream& in, std::vector<double>& values,
+                 BadInputPolicy policy = BAD_INPUT_ERROR);
+
 /**
  * @file lexicon.h
  *
@@ -210,6 +1679,22 @@ std::string getLine(std::string prompt = "");
 #include <cctype>
 #include <stack>
 #include <set>
+#include <vector>
+#include <type_traits>
+#include <atomic>
+#include <memory>
+#include <forward_list>
+#include <mutex>
+
+/*
+ * Build option: LEXICON_CHILD_INDEX
+ * ---------------------------------
+ * Defining LEXICON_CHILD_INDEX as 1 makes every Lexicon build its child
+ * index by default; see Lexicon::setChildIndexEnabled.
+ */
+#ifndef LEXICON_CHILD_INDEX
+#define LEXICON_CHILD_INDEX 0
+#endif
 
 /**
  * @class Lexicon
@@ -239,143 +1724,361 @@ std::string getLine(std::string prompt = "");
  *    }
  * ~~~
  */
-class Lexicon {
+class Lexicon {
+
+public:
+
+/** \_overload */
+    Lexicon();
+/**
+ * Initializes a new lexicon.  The default constructor creates an empty
+ * lexicon.  The second form reads in the contents of the lexicon from
+ * the specified data file.  The data file must be in one of two formats:
+ * <ol>
+ *  <li>A space-efficient precompiled binary format, or
+ *  <li>A text file containing one word per line.
+ * </ol>
+ * The Stanford-Whittier library distribution
+ * includes a binary lexicon file named <code>EnglishWords.dat</code>
+ * containing more than 127,000 English words.  The standard code pattern
+ * to initialize that lexicon looks like this:
+ *
+ * ~~~
+ *    Lexicon english("EnglishWords.dat");
+ * ~~~
+ *
+ * Sample usages:
+ *
+ *     Lexicon lex;
+ *     Lexicon lex(filename);
+ */
+   Lexicon(std::string filename);
+
+
+/**
+ * Deallocates any storage associated with this lexicon.
+ */
+   virtual ~Lexicon();
+
+
+/**
+ * Compares two lexicons for equality.
+ * Identical in behavior to the \c == operator.
+ *
+ * Sample usage:
+ *
+ *      if (lex1.equals(lex2)) ...
+ */
+    bool equals(const Lexicon& lex2) const;
+
+
+/**
+ * Returns the number of words contained in this lexicon.
+ *
+ * Sample usage:
+ *
+ *     int n = lex.size();
+ */
+   int size() const;
+
+
+/**
+ * Returns \c true if this lexicon contains no words.
+ *
+ * Sample usage:
+ *
+ *     if (lex.isEmpty()) ...
+ */
+   bool isEmpty() const;
+
+
+/**
+ * Removes all words from the lexicon.
+ *
+ * Sample usage:
+ *
+ *     lex.clear();
+ */
+   void clear();
+
+
+/**
+ * Adds the specified word to the lexicon.
+ *
+ * Sample usage:
+ *
+ *     lex.add(word);
+ */
+   void add(std::string word);
+
+
+/**
+ * Reads a file and adds all of its words to the lexicon.
+ * The file must be in one of the two formats specified in the
+ * description of the Lexicon class. Moreover, if the file is in
+ * the binary format, this lexicon must be empty when this method
+ * is called or this method will signal an error.  The lines of a
+ * text file may end with either a newline or a carriage return and a
+ * newline, and the words are added in a single bulk step.
+ *
+ * Sample usage:
+ *
+ *     lex.addWordsFromFile(filename);
+ */
+   void addWordsFromFile(std::string filename);
+
+
+/**
+ * Moves the words that have been added individually into the lexicon's
+ * DAWG, rebuilding it as a minimal DAWG of all its words.  Afterwards
+ * lookups and iteration run over the compact edge array instead of a
+ * tree of separately allocated strings.  Words containing characters
+ * other than the letters a-z cannot be stored in a DAWG and stay where
+ * they are.
+ *
+ * Sample usage:
+ *
+ *     lex.compact();
+ */
+   void compact();
+
+
+/**
+ * Writes the words of this lexicon to a file in the portable binary
+ * format, which can be read back with \ref addWordsFromFile or the
+ * constructor.  Words added individually are folded into the saved
+ * DAWG; this method signals an error if any word contains characters
+ * other than the letters a-z.
+ *
+ * Sample usage:
+ *
+ *     lex.saveBinary("MyWords.dat");
+ */
+   void saveBinary(std::string filename) const;
+
+
+/**
+ * Writes the words of this lexicon to a file in the native binary
+ * format, conventionally given a <code>.dawg2</code> extension.  Unlike
+ * the portable binary format, a native file is stored in this machine's
+ * byte order and records its word count, so loading it with
+ * \ref addWordsFromFile maps the file into memory and uses it in place:
+ * startup does no parsing, and processes loading the same file share
+ * its memory.  As for \ref saveBinary, every word must consist of the
+ * letters a-z only.
+ *
+ * Sample usage:
+ *
+ *     lex.saveNativeBinary("EnglishWords.dawg2");
+ */
+   void saveNativeBinary(std::string filename) const;
+
+
+/**
+ * Returns \c true if \em word is contained in this
+ * lexicon.  In the `%Lexicon` class, the case of letters is
+ * ignored, so "Zoo" is the same as "ZOO" or "zoo".
+ *
+ * Sample usage:
+ *
+ *     if (lex.contains(word)) ...
+ */
+   bool contains(std::string_view word) const;
 
-public:
 
-/** \_overload */
-    Lexicon();
 /**
- * Initializes a new lexicon.  The default constructor creates an empty
- * lexicon.  The second form reads in the contents of the lexicon from
- * the specified data file.  The data file must be in one of two formats:
- * <ol>
- *  <li>A space-efficient precompiled binary format, or
- *  <li>A text file containing one word per line.
- * </ol>
- * The Stanford-Whittier library distribution
- * includes a binary lexicon file named <code>EnglishWords.dat</code>
- * containing more than 127,000 English words.  The standard code pattern
- * to initialize that lexicon looks like this:
- *
- * ~~~
- *    Lexicon english("EnglishWords.dat");
- * ~~~
+ * Looks up \em count words at once, storing in <code>results[i]</code>
+ * whether <code>words[i]</code> is contained in this lexicon.  The
+ * result is the same as calling \ref contains on each word, but the
+ * lookups are interleaved so that their memory accesses overlap, which
+ * makes checking many words considerably faster.  The second form
+ * returns the results as a vector.
  *
  * Sample usages:
  *
- *     Lexicon lex;
- *     Lexicon lex(filename);
+ *     lex.containsBatch(words, count, results);
+ *     vector<bool> found = lex.containsBatch(words);
  */
-   Lexicon(std::string filename);
+   void containsBatch(const std::string_view *words, int count, bool *results) const;
+   std::vector<bool> containsBatch(const std::vector<std::string_view>& words) const;
 
 
 /**
- * Deallocates any storage associated with this lexicon.
+ * Returns \c true if any words in this lexicon begin with the string \em prefix.
+ * Like \ref contains, this method ignores the case of letters
+ * so that "MO" is a prefix of both "monkey" and "Monday".
+ *
+ * Sample usage:
+ *
+ *     if (lex.containsPrefix(prefix)) ...
  */
-   virtual ~Lexicon();
+   bool containsPrefix(std::string_view prefix) const;
 
 
 /**
- * Compares two lexicons for equality.
- * Identical in behavior to the \c == operator.
+ * Checks \em count prefixes at once, storing in <code>results[i]</code>
+ * whether any word in this lexicon begins with <code>prefixes[i]</code>.
+ * Like \ref containsBatch, this is equivalent to calling
+ * \ref containsPrefix on each prefix, but faster for large batches.
  *
- * Sample usage:
+ * Sample usages:
  *
- *      if (lex1.equals(lex2)) ...
+ *     lex.containsPrefixBatch(prefixes, count, results);
+ *     vector<bool> found = lex.containsPrefixBatch(prefixes);
  */
-    bool equals(const Lexicon& lex2) const;
+   void containsPrefixBatch(const std::string_view *prefixes, int count, bool *results) const;
+   std::vector<bool> containsPrefixBatch(const std::vector<std::string_view>& prefixes) const;
 
 
 /**
- * Returns the number of words contained in this lexicon.
+ * Returns the position of \em word in the alphabetical order of the
+ * words in this lexicon, counting from 0, or -1 if the word is not in
+ * the lexicon.  Together with \ref wordAt, this gives every word a
+ * dense numeric identifier.  For words stored in the DAWG the cost is
+ * proportional to the length of the word; words added individually
+ * add a cost proportional to their number.  Like \ref contains, this
+ * method ignores the case of letters.
  *
  * Sample usage:
  *
- *     int n = lex.size();
+ *     int id = lex.indexOf(word);
  */
-   int size() const;
+   int indexOf(std::string_view word) const;
 
 
 /**
- * Returns \c true if this lexicon contains no words.
+ * Returns the word at position \em index in the alphabetical order of
+ * the words in this lexicon, so that
+ * <code>lex.wordAt(lex.indexOf(word))</code> is \em word in lowercase.
+ * This method signals an error if \em index is not between 0 and
+ * <code>size() - 1</code>.
  *
  * Sample usage:
  *
- *     if (lex.isEmpty()) ...
+ *     string word = lex.wordAt(id);
  */
-   bool isEmpty() const;
+   std::string wordAt(int index) const;
 
 
 /**
- * Removes all words from the lexicon.
+ * Returns up to \em limit words of this lexicon that are within
+ * \em maxDistance edits of \em word, where an edit inserts, deletes or
+ * replaces one letter.  The words are ordered by their distance from
+ * \em word and then alphabetically.  The search walks the DAWG once,
+ * abandoning every branch that is already too far from \em word, so
+ * its cost depends on how much of the lexicon is close to the word
+ * rather than on the size of the lexicon.  Like \ref contains, this
+ * method ignores the case of letters.
  *
  * Sample usage:
  *
- *     lex.clear();
+ *     vector<string> close = lex.suggest("recieve", 2, 10);
  */
-   void clear();
+   std::vector<std::string> suggest(std::string_view word, int maxDistance,
+                                    int limit) const;
 
 
 /**
- * Adds the specified word to the lexicon.
+ * Turns the child index on or off.  The child index is a side table,
+ * built whenever the DAWG is loaded, that lets \ref contains and
+ * \ref containsPrefix find each successive letter with a single lookup
+ * instead of a search through the alternatives at that point in the
+ * DAWG.  It costs four bytes per DAWG edge; \ref childIndexMemoryUsage
+ * reports the exact amount.  The initial setting is given by the
+ * build option <code>LEXICON_CHILD_INDEX</code>, which is off unless
+ * defined as 1.
  *
  * Sample usage:
  *
- *     lex.add(word);
+ *     lex.setChildIndexEnabled(true);
  */
-   void add(std::string word);
+   void setChildIndexEnabled(bool enabled);
 
 
 /**
- * Reads a file and adds all of its words to the lexicon.
- * The file must be in one of the two formats specified in the
- * description of the Lexicon class. Moreover, if the file is in
- * the binary format, this lexicon must be empty when this method
- * is called or this method will signal an error.
+ * Returns \c true if this lexicon maintains a child index.
+ */
+   bool isChildIndexEnabled() const;
+
+
+/**
+ * Returns the number of bytes of memory used by the child index,
+ * which is zero when the index is turned off.
+ */
+   size_t childIndexMemoryUsage() const;
+
+
+/**
+ * Calls the specified function on each word in this lexicon.
  *
  * Sample usage:
  *
- *     lex.addWordsFromFile(filename);
+ *     lexicon.mapAll(fn);
  */
-   void addWordsFromFile(std::string filename);
+   void mapAll(void (*fn)(std::string)) const;
+   void mapAll(void (*fn)(const std::string &)) const;
+   template <typename FunctorType>
+   void mapAll(FunctorType fn) const;
 
 
 /**
- * Returns \c true if \em word is contained in this
- * lexicon.  In the `%Lexicon` class, the case of letters is
- * ignored, so "Zoo" is the same as "ZOO" or "zoo".
+ * Calls the specified function on each word in this lexicon, in
+ * alphabetical order, passing the word as a <code>std::string_view</code>.
+ * Unlike \ref mapAll and range-based iteration, no string is created
+ * for each word: the view refers to a buffer that is reused for the
+ * next word, so it is valid only until the function returns.  If the
+ * function returns a \c bool, returning \c false stops the traversal.
  *
  * Sample usage:
  *
- *     if (lex.contains(word)) ...
+ *     lex.forEachWord([](string_view word) { ... });
  */
-   bool contains(std::string word) const;
+   template <typename FunctorType>
+   void forEachWord(FunctorType fn) const;
 
 
 /**
- * Returns \c true if any words in this lexicon begin with the string \em prefix.
- * Like \ref contains, this method ignores the case of letters
- * so that "MO" is a prefix of both "monkey" and "Monday".
+ * Calls the specified function, in the same way as \ref forEachWord,
+ * on each word in this lexicon that begins with \em prefix, in
+ * alphabetical order.  The traversal starts directly at the point in
+ * the DAWG where \em prefix ends, so its cost depends on the number of
+ * words visited rather than on the size of the lexicon; returning
+ * \c false from the function after the first few words is a cheap way
+ * to list the leading completions of a prefix.  Like \ref contains,
+ * this method ignores the case of letters.
  *
  * Sample usage:
  *
- *     if (lex.containsPrefix(prefix)) ...
+ *     lex.forEachWithPrefix("un", [](string_view word) { ... });
  */
-   bool containsPrefix(std::string prefix) const;
+   template <typename FunctorType>
+   void forEachWithPrefix(std::string_view prefix, FunctorType fn) const;
 
 
 /**
- * Calls the specified function on each word in this lexicon.
+ * Calls the specified function, in the same way as \ref forEachWord,
+ * on each word in this lexicon that matches \em pattern, in
+ * alphabetical order.  In the pattern, <code>?</code> matches any
+ * single character and <code>*</code> matches any sequence of
+ * characters, including none; every other character matches itself,
+ * ignoring case.  Words added with \ref add may contain characters
+ * other than letters, and the wildcards match those as well.
+ * The letters before the first wildcard are looked up directly, and
+ * parts of the DAWG that cannot match are never visited.  This method
+ * signals an error if the pattern is longer than
+ * \ref MAX_PATTERN_LENGTH characters.
  *
  * Sample usage:
  *
- *     lexicon.mapAll(fn);
+ *     lex.forEachMatch("un*able", [](string_view word) { ... });
  */
-   void mapAll(void (*fn)(std::string)) const;
-   void mapAll(void (*fn)(const std::string &)) const;
    template <typename FunctorType>
-   void mapAll(FunctorType fn) const;
+   void forEachMatch(std::string_view pattern, FunctorType fn) const;
+
+/**
+ * The length of the longest pattern accepted by \ref forEachMatch.
+ */
+   static const int MAX_PATTERN_LENGTH = 63;
 
 
     /** \_overload */ // Not really. Just a comment-hack for Doxygen.
@@ -440,9 +2143,28 @@ private:
    };
 #pragma pack(pop)
 
+#if defined(__cpp_lib_memory_resource)
+   typedef std::pmr::set<std::string_view, std::less<> > WordSet;
+#else
+   typedef std::set<std::string_view, std::less<> > WordSet;
+#endif
+
    Edge *edges, *start;
    int numEdges, numDawgWords;
-   std::set<std::string> otherWords;
+#if defined(__cpp_lib_memory_resource)
+   std::pmr::monotonic_buffer_resource wordArena;   /* Holds otherWords */
+   WordSet otherWords{WordSet::allocator_type(&wordArena)};
+#else
+   std::forward_list<std::string> wordStore;        /* Holds otherWords */
+   WordSet otherWords;
+#endif
+   void *mappedData;     /* Mapping that holds edges, or NULL if owned */
+   size_t mappedSize;
+   bool childIndexEnabled;
+   std::vector<uint32_t> childMasks;  /* Letters below each node, by edge */
+   mutable std::vector<int> wordsThrough;   /* Rank index, by edge */
+   mutable std::atomic<bool> rankIndexReady;
+   mutable std::mutex rankIndexLock;
 
 public:
 
@@ -478,13 +2200,24 @@ public:
       std::string tmpWord;
       Edge *edgePtr;
       std::stack<Edge *> stack;
-      std::set<std::string>::iterator setIterator;
-      std::set<std::string>::iterator setEnd;
+      WordSet::const_iterator setIterator;
+      WordSet::const_iterator setEnd;
 
       void advanceToNextWordInDawg();
       void advanceToNextWordInSet();
       void advanceToNextEdge();
 
+      /* Compares the whole DAWG word, not just its prefix, with the set word */
+      bool dawgWordPrecedesSetWord() const {
+         size_t len = currentDawgPrefix.length();
+         int cmp = currentSetWord.compare(0, len, currentDawgPrefix);
+         if (cmp != 0) return cmp > 0;
+         if (currentSetWord.length() <= len) return false;
+         unsigned char last = lp->ordToChar(edgePtr->letter);
+         unsigned char next = currentSetWord[len];
+         return last < next || (last == next && currentSetWord.length() > len + 1);
+      }
+
    public:
       iterator() {
          this->lp = NULL;
@@ -514,13 +2247,14 @@ public:
          edgePtr = it.edgePtr;
          stack = it.stack;
          setIterator = it.setIterator;
+         setEnd = it.setEnd;
       }
 
       iterator & operator++() {
          if (edgePtr == NULL) {
             advanceToNextWordInSet();
          } else {
-            if (currentSetWord == "" || currentDawgPrefix < currentSetWord) {
+            if (currentSetWord == "" || dawgWordPrecedesSetWord()) {
                advanceToNextWordInDawg();
             } else {
                advanceToNextWordInSet();
@@ -546,7 +2280,7 @@ public:
 
       std::string operator*() {
          if (edgePtr == NULL) return currentSetWord;
-         if (currentSetWord == "" || currentDawgPrefix < currentSetWord) {
+         if (currentSetWord == "" || dawgWordPrecedesSetWord()) {
             return currentDawgPrefix + lp->ordToChar(edgePtr->letter);
          } else {
             return currentSetWord;
@@ -555,7 +2289,7 @@ public:
 
       std::string *operator->() {
          if (edgePtr == NULL) return &currentSetWord;
-         if (currentSetWord == "" || currentDawgPrefix < currentSetWord) {
+         if (currentSetWord == "" || dawgWordPrecedesSetWord()) {
             tmpWord = currentDawgPrefix + lp->ordToChar(edgePtr->letter);
             return &tmpWord;
          } else {
@@ -576,47 +2310,415 @@ public:
 private:
 
    Edge *findEdgeForChar(Edge *children, char ch) const;
-   Edge *traceToLastEdge(const std::string & s) const;
+   Edge *traceToLastEdge(std::string_view s) const;
+   void traceBatch(const std::string_view *words, int count,
+                   bool *results, bool prefixes) const;
+   bool otherWordsContain(std::string_view word) const;
+   bool otherWordsContainPrefix(std::string_view prefix) const;
+   std::string_view internWord(std::string_view word);
+   void addWordsFromText(char *text, size_t length);
+   void clearOtherWords();
    void readBinaryFile(std::string filename);
+   void readNativeBinaryFile(std::string filename);
+   void checkEdges(std::string filename);
+   void releaseEdges();
+   void compactForSave(std::string caller);
+   void rebuildChildIndex();
    void deepCopy(const Lexicon & src);
-   int countDawgWords(Edge *start) const;
+   const std::vector<int>& rankIndex() const;
+   void buildRankIndex() const;
+   int dawgWordsThroughNode(const Edge *node) const;
+   int dawgWordsBefore(std::string_view word, bool& found) const;
+   std::string dawgWordAt(int index) const;
+   struct SuggestSearch;
+   void suggestFromDawg(Edge *node, int depth, SuggestSearch& search) const;
+   void suggestFromOtherWords(SuggestSearch& search) const;
 
    unsigned int charToOrd(char ch) const {
-      return ((unsigned int)(tolower(ch) - 'a' + 1));
+      return ((unsigned int)(tolower((unsigned char) ch) - 'a' + 1));
    }
 
    char ordToChar(unsigned int ord) const {
       return ((char)(ord - 1 + 'a'));
    }
+
+/*
+ * Private class: Lexicon::WordPattern
+ * -----------------------------------
+ * A compiled wildcard pattern.  The pattern is matched by simulating a
+ * nondeterministic automaton whose states are the positions in the
+ * pattern, with the set of current states held as the bits of a word:
+ * bit i means that the text so far can be followed by pattern[i..].
+ */
+
+   class WordPattern {
+   public:
+      typedef uint64_t StateSet;
+
+      WordPattern(std::string_view pattern);
+
+      StateSet initialStates() const;
+      StateSet step(StateSet states, char ch) const;
+      bool accepts(StateSet states) const;
+      bool matches(std::string_view word) const;
+
+      /* The letters before the first wildcard */
+      const std::string& literalPrefix() const {
+         return prefix;
+      }
+
+   private:
+      std::string prefix;
+      StateSet letterMasks[256];    /* Positions matching each character */
+      StateSet starMask;            /* Positions holding a star          */
+      StateSet acceptMask;          /* The position past the end         */
+
+      StateSet closure(StateSet states) const;
+   };
+
+/*
+ * Private class: Lexicon::WordCursor
+ * ----------------------------------
+ * A WordCursor steps through the words of a lexicon in alphabetical
+ * order, merging the DAWG with otherWords.  The current DAWG word is
+ * kept in a buffer that is extended and truncated in place as the
+ * traversal moves through the graph, so stepping allocates nothing
+ * once the buffer has reached the length of the longest word.
+ */
+
+   class WordCursor {
+   public:
+      WordCursor(const Lexicon *lp);
+      WordCursor(const Lexicon *lp, std::string_view prefix);
+      WordCursor(const Lexicon *lp, const WordPattern *pattern);
+      bool next(std::string_view& word);
+
+   private:
+      const Lexicon *lp;
+      const WordPattern *pattern;   /* Filter on the words, or NULL    */
+      std::string prefix;           /* Shared by all the words         */
+      Edge *root;                   /* Where the DAWG traversal starts */
+      size_t fixedEdges;            /* Leading path entries kept fixed */
+      std::vector<Edge *> path;     /* Edges from the root to the word */
+      std::string dawgWord;         /* Letters along path              */
+      std::vector<WordPattern::StateSet> states; /* Pattern after path */
+      WordPattern::StateSet baseStates; /* Pattern before path         */
+      bool dawgStarted;
+      bool dawgValid;               /* dawgWord is the next DAWG word  */
+      WordSet::const_iterator setIterator;
+      enum { FROM_NEITHER, FROM_DAWG, FROM_SET } consumed;
+
+      void init(std::string_view prefix);
+      bool advanceDawg();
+      bool topCanMatch();
+      void skipUnmatchedSetWords();
+   };
+
+/*
+ * Calls fn on word and reports whether the traversal should continue,
+ * which it always should unless fn returns a bool.
+ */
+   template <typename FunctorType>
+   static bool visitWord(FunctorType& fn, std::string_view word) {
+      if constexpr (std::is_same<decltype(fn(word)), bool>::value) {
+         return fn(word);
+      } else {
+         fn(word);
+         return true;
+      }
+   }
+
    friend std::ostream& operator <<(std::ostream& os, const Lexicon& lex);
+   friend class LexiconSnapshot;
+};
+
+template <typename FunctorType>
+void Lexicon::mapAll(FunctorType fn) const {
+   std::string word;
+   forEachWord([&fn, &word](std::string_view view) {
+      word.assign(view.data(), view.length());
+      fn(word);
+   });
+}
+
+template <typename FunctorType>
+void Lexicon::forEachWord(FunctorType fn) const {
+   WordCursor cursor(this);
+   std::string_view word;
+   while (cursor.next(word)) {
+      if (!visitWord(fn, word)) return;
+   }
+}
+
+template <typename FunctorType>
+void Lexicon::forEachWithPrefix(std::string_view prefix, FunctorType fn) const {
+   WordCursor cursor(this, prefix);
+   std::string_view word;
+   while (cursor.next(word)) {
+      if (!visitWord(fn, word)) return;
+   }
+}
+
+template <typename FunctorType>
+void Lexicon::forEachMatch(std::string_view pattern, FunctorType fn) const {
+   WordPattern compiled(pattern);
+   WordCursor cursor(this, &compiled);
+   std::string_view word;
+   while (cursor.next(word)) {
+      if (!visitWord(fn, word)) return;
+   }
+}
+
+/*
+ * Hashing function for strings
+ */
+int hashCode(const std::string& str);
+
+/*
+ * Hashing function for lexicons
+ */
+int hashCode(const Lexicon& l);
+
+/**
+ * Overloads the `<<` operator so that it is able
+ * to display lexicons.
+ *
+ * Sample usage:
+ *
+ *     cout << lex;
+ */
+std::ostream& operator <<(std::ostream& os, const Lexicon& lex);
+
+/**
+ * @class LexiconSnapshot
+ *
+ * An immutable copy of a lexicon that any number of threads may query
+ * at once without locking.  The DAWG is copied as is and the words
+ * added with <code>add</code> are frozen into a sorted array, so that
+ * no lookup touches anything that could change.  Snapshots are shared
+ * through <code>SharedLexicon</code>:
+ *
+ * ~~~
+ *    SharedLexicon shared(std::make_shared<LexiconSnapshot>(english));
+ *    ...
+ *    // In each request handler thread
+ *    SharedLexicon::Reader reader(shared);
+ *    if (reader.get().contains(word)) ...
+ *    ...
+ *    // In the thread that updates the word list
+ *    shared.publish(std::make_shared<LexiconSnapshot>(updated));
+ * ~~~
+ */
+class LexiconSnapshot {
+
+public:
+
+/**
+ * Freezes the current contents of lex.
+ */
+   explicit LexiconSnapshot(const Lexicon& lex);
+
+/**
+ * Returns true if word is contained in the snapshot.  Lookups are
+ * case-insensitive, as they are for <code>Lexicon</code>.
+ */
+   bool contains(std::string_view word) const;
+
+/**
+ * Returns true if any words in the snapshot begin with prefix.
+ */
+   bool containsPrefix(std::string_view prefix) const;
+
+/**
+ * Looks up count words at once, storing whether each one is contained
+ * in the corresponding element of results.
+ */
+   void containsBatch(const std::string_view *words, int count, bool *results) const;
+
+/**
+ * Returns the number of words contained in the snapshot.
+ */
+   int size() const;
+
+/**
+ * Returns true if the snapshot contains no words.
+ */
+   bool isEmpty() const;
+
+private:
+   Lexicon dawg;                        /* DAWG only; otherWords is empty */
+   std::vector<std::string> extraWords; /* Sorted words added with add   */
+
+   bool extraWordsContain(std::string_view word) const;
+   bool extraWordsContainPrefix(std::string_view prefix) const;
+};
+
+/**
+ * @class SharedLexicon
+ *
+ * Holds the current <code>LexiconSnapshot</code> and lets a writer
+ * replace it while other threads are reading, in the manner of
+ * read-copy-update: readers keep using the snapshot they already have
+ * until they next look, and an old snapshot is freed once the last
+ * reader lets go of it.
+ */
+class SharedLexicon {
+
+public:
+
+/**
+ * Creates a holder containing snapshot, or an empty lexicon if none
+ * is given.
+ */
+   SharedLexicon();
+   explicit SharedLexicon(std::shared_ptr<const LexiconSnapshot> snapshot);
+
+/**
+ * Returns the current snapshot.  Each call copies a shared pointer,
+ * so threads doing many lookups should go through a
+ * <code>Reader</code> instead.
+ */
+   std::shared_ptr<const LexiconSnapshot> load() const;
+
+/**
+ * Replaces the current snapshot.  Readers see the new one the next
+ * time they call <code>Reader::get</code>.
+ */
+   void publish(std::shared_ptr<const LexiconSnapshot> snapshot);
+
+/**
+ * Returns the number of snapshots published since construction.
+ */
+   uint64_t version() const;
+
+/**
+ * @class SharedLexicon::Reader
+ *
+ * A per-thread handle that caches the current snapshot.  While no new
+ * snapshot has been published, <code>get</code> only reads the version
+ * number, so readers on different cores never write to memory they
+ * share and lookups scale with the number of threads.  A reader must
+ * not be used by more than one thread at a time.
+ */
+   class Reader {
+   public:
+      explicit Reader(const SharedLexicon& source);
+
+/**
+ * Returns the most recently published snapshot.  The reference stays
+ * valid until the next call to <code>get</code> on this reader.
+ */
+      const LexiconSnapshot& get();
+
+   private:
+      const SharedLexicon *source;
+      uint64_t seenVersion;
+      std::shared_ptr<const LexiconSnapshot> cached;
+   };
+
+private:
+   std::shared_ptr<const LexiconSnapshot> current;
+   std::atomic<uint64_t> publishedVersion;
+
+   SharedLexicon(const SharedLexicon&) = delete;
+   SharedLexicon& operator=(const SharedLexicon&) = delete;
 };
 
-template <typename FunctorType>
-void Lexicon::mapAll(FunctorType fn) const {
-   for (std::string word : *this) {
-      fn(word);
+// Grid ---------------------------------------------------------
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+ * Bounds checking for Grid subscripts
+ * -----------------------------------
+ * Defining GRID_NO_BOUNDS_CHECK before including this header removes
+ * the range checks from <code>grid[row][col]</code>, so that loops over
+ * a grid compile to plain array accesses.  An index outside the grid
+ * then has undefined behavior instead of signaling an error.  The
+ * get and set methods are always checked.
+ */
+
+/**
+ * @class GridSpan
+ *
+ * A view of a contiguous run of grid elements, such as one row, given
+ * by a pointer and a length.  In C++20 this is <code>std::span</code>;
+ * earlier standards get a minimal class with the same basic interface.
+ */
+#if __cplusplus >= 202002L
+#include <span>
+template <typename T>
+using GridSpan = std::span<T>;
+#else
+template <typename T>
+class GridSpan {
+public:
+   GridSpan() : ptr(NULL), len(0) {
+      /* Empty */
+   }
+
+   GridSpan(T *data, size_t size) : ptr(data), len(size) {
+      /* Empty */
+   }
+
+   T *data() const {
+      return ptr;
+   }
+
+   size_t size() const {
+      return len;
+   }
+
+   bool empty() const {
+      return len == 0;
+   }
+
+   T & operator[](size_t index) const {
+      return ptr[index];
+   }
+
+   T *begin() const {
+      return ptr;
+   }
+
+   T *end() const {
+      return ptr + len;
    }
-}
 
-/*
- * Hashing function for lexicons
- */
-int hashCode(const Lexicon& l);
+private:
+   T *ptr;
+   size_t len;
+};
+#endif
 
-/**
- * Overloads the `<<` operator so that it is able
- * to display lexicons.
- *
- * Sample usage:
- *
- *     cout << lex;
+/*
+ * The header of a grid file written by Grid::saveBinary.  The
+ * elements follow the header as raw bytes in row-major order.  The
+ * byte-order mark is 0x01020304 in the byte order of the machine that
+ * wrote the file, and the header is 32 bytes long so that the
+ * elements start on an aligned offset.
  */
-std::ostream& operator <<(std::ostream& os, const Lexicon& lex);
-
-// Grid ---------------------------------------------------------
+struct GridFileHeader {
+   char magic[4];             /* "GRID"                               */
+   uint32_t byteOrder;        /* GRID_BYTE_ORDER_MARK                */
+   uint32_t nRows;
+   uint32_t nCols;
+   uint32_t elementSize;      /* sizeof(ValueType) of the writer     */
+   uint32_t reserved[3];
+};
 
-#include <sstream>
-#include <vector>
+static const uint32_t GRID_BYTE_ORDER_MARK = 0x01020304;
 
 /**
  * @class Grid
@@ -707,6 +2809,20 @@ public:
    void resize(int nRows, int nCols, bool retain = false);
 
 
+/**
+ * Makes room for a grid of the specified size without changing the
+ * contents of this grid, so that later calls to \ref resize up to
+ * that size do not need to allocate memory.  The grid never gives
+ * memory back when it shrinks, so a grid that is resized repeatedly
+ * allocates only when it grows beyond every earlier size.
+ *
+ * Sample usage:
+ *
+ *     grid.reserve(nRows, nCols);
+ */
+   void reserve(int nRows, int nCols);
+
+
 /**
  * Returns \c true if this grid contains exactly the same
  * values as the given other grid.
@@ -729,6 +2845,35 @@ public:
    void fill(const ValueType& value);
 
 
+/**
+ * Writes the dimensions and elements of this grid to the specified
+ * file in a compact binary format, which \ref loadBinary reads back.
+ * The elements are written as their raw bytes, so this method is only
+ * available when <code>ValueType</code> is trivially copyable, and the
+ * file can only be read on a machine with the same byte order and
+ * type sizes.  This method signals an error if the file cannot be
+ * written.
+ *
+ * Sample usage:
+ *
+ *     grid.saveBinary("checkpoint.grid");
+ */
+   void saveBinary(const std::string& filename) const;
+
+
+/**
+ * Replaces the contents of this grid with a grid saved by
+ * \ref saveBinary.  This method signals an error if the file cannot
+ * be read, is not a grid file, or was written with a different element
+ * size or byte order.
+ *
+ * Sample usage:
+ *
+ *     grid.loadBinary("checkpoint.grid");
+ */
+   void loadBinary(const std::string& filename);
+
+
 /**
  * Returns \c true if the specified row and column position
  * is inside the bounds of the grid.
@@ -780,6 +2925,61 @@ public:
    const GridRowConst operator [](int row) const;
 
 
+/**
+ * Returns the elements of the specified row as a contiguous span,
+ * for loops that process a row at a time without going through
+ * <code>operator[]</code>.  This method signals an error if the row
+ * is outside the grid boundaries.
+ *
+ * Sample usage:
+ *
+ *     for (ValueType& value : grid.row(r)) ...
+ */
+   GridSpan<ValueType> row(int row);
+   GridSpan<const ValueType> row(int row) const;
+
+
+/**
+ * Returns a pointer to the first element of this grid.  The elements
+ * are stored in row-major order, with the element at
+ * (\em row, \em col) at offset <code>row * stride() + col</code>.
+ *
+ * Sample usage:
+ *
+ *     ValueType *p = grid.data();
+ */
+   ValueType *data();
+   const ValueType *data() const;
+
+
+/**
+ * Returns the distance, in elements, between the starts of
+ * consecutive rows in \ref data.
+ *
+ * Sample usage:
+ *
+ *     int stride = grid.stride();
+ */
+   int stride() const;
+
+
+/**
+ * Returns the element at the specified (\em row, \em col)
+ * location without checking that the location is inside the grid.
+ *
+ * Sample usage:
+ *
+ *     grid.atUnchecked(row, col) = value;
+ */
+   ValueType & atUnchecked(int row, int col) {
+      return elements[size_t(row) * nCols + col];
+   }
+
+   const ValueType & atUnchecked(int row, int col) const {
+      return elements[size_t(row) * nCols + col];
+   }
+
+
 /**
  * Returns a printable string representation of this grid.
  *
@@ -806,6 +3006,116 @@ public:
    void mapAll(FunctorType fn) const;
 
 
+/**
+ * Calls the specified function on each element of this grid, using
+ * all the available processor cores.  The grid is divided into blocks
+ * of consecutive rows, each processed by a separate thread, so the
+ * function must be safe to call from several threads at once and the
+ * order of the calls is unspecified.  On a non-const grid the function
+ * receives a reference through which it may change the element.
+ * Grids too small to benefit are processed on the calling thread.  If
+ * the function throws an exception, the remaining blocks still run
+ * and the first exception is rethrown.
+ *
+ * Sample usage:
+ *
+ *     grid.parallelForEach([](double& x) { x *= 2; });
+ */
+   template <typename FunctorType>
+   void parallelForEach(FunctorType fn);
+   template <typename FunctorType>
+   void parallelForEach(FunctorType fn) const;
+
+
+/**
+ * Stores <code>fn(value)</code> in \em dst for each element of this
+ * grid, in parallel as in \ref parallelForEach.  The destination is
+ * resized to match this grid if its dimensions differ, and may be this
+ * grid itself.
+ *
+ * Sample usage:
+ *
+ *     grid.transform(result, [](int x) { return x * x; });
+ */
+   template <typename ResultType, typename FunctorType>
+   void transform(Grid<ResultType>& dst, FunctorType fn) const;
+
+
+/**
+ * Combines the elements of this grid with \em op, in parallel as in
+ * \ref parallelForEach, and returns the result combined with
+ * \em init.  As with <code>std::reduce</code>, \em op must be
+ * associative and commutative, because the elements are grouped and
+ * ordered differently depending on the number of threads.
+ *
+ * Sample usage:
+ *
+ *     double total = grid.reduce(0.0, std::plus<double>());
+ */
+   template <typename T, typename BinaryOp>
+   T reduce(T init, BinaryOp op) const;
+
+
+/**
+ * Provides the neighbors of one cell to the function passed to
+ * \ref stencil.  <code>n(dRow, dCol)</code> is the element \em dRow
+ * rows and \em dCol columns away from the cell, or the outside value
+ * if that position is not in the grid.
+ */
+   class Neighborhood {
+   public:
+      const ValueType & operator()(int dRow, int dCol) const {
+         int r = cellRow + dRow;
+         int c = cellCol + dCol;
+         if (interior || gp->inBounds(r, c)) {
+            return gp->elements[size_t(r) * gp->nCols + c];
+         }
+         return *outside;
+      }
+
+      int row() const {
+         return cellRow;
+      }
+
+      int col() const {
+         return cellCol;
+      }
+
+   private:
+      Neighborhood(const Grid *gp, const ValueType *outside)
+         : gp(gp), outside(outside) {
+         /* Empty */
+      }
+
+      const Grid *gp;
+      const ValueType *outside;
+      int cellRow;
+      int cellCol;
+      bool interior;        /* Every neighbor within the radius is inside */
+      friend class Grid;
+   };
+
+
+/**
+ * Stores <code>fn(n)</code> in \em dst for each cell of this grid,
+ * where \em n is the \ref Neighborhood of the cell.  The function
+ * may look at neighbors up to \em radius rows and columns away;
+ * positions outside the grid read as \em outside.  The work is done
+ * in parallel as in \ref parallelForEach.  Each thread writes only its
+ * own rows of \em dst but reads the rows around them from this grid,
+ * so \em dst must be a different grid, which is resized to match this
+ * one if necessary.  This method signals an error if the two grids are
+ * the same.
+ *
+ * Sample usage:
+ *
+ *     life.stencil(next, 1, [](const Grid<int>::Neighborhood& n) { ... });
+ */
+   template <typename ResultType, typename FunctorType>
+   void stencil(Grid<ResultType>& dst, int radius, FunctorType fn,
+                const ValueType& outside = ValueType()) const;
+
+
 /*
  * Additional Grid operations
  * --------------------------
@@ -856,6 +3166,11 @@ private:
  * is in row-major order, which is to say that the entire first row
  * is laid out contiguously, followed by the entire second row,
  * and so on.
+ *
+ * The array is raw memory aligned to a cache line and may have room
+ * for more elements than the grid holds.  Only the first
+ * nRows * nCols slots contain constructed elements, each of which is
+ * value-initialized exactly once when it comes into use.
  */
 
 /* Instance variables */
@@ -863,10 +3178,22 @@ private:
    ValueType *elements;  /* A dynamic array of the elements   */
    int nRows;            /* The number of rows in the grid    */
    int nCols;            /* The number of columns in the grid */
+   size_t capacity;      /* The number of slots in the array  */
+
+/* Alignment of the array, which is at least a cache line */
+   static constexpr size_t ELEMENT_ALIGNMENT =
+      alignof(ValueType) > 64 ? alignof(ValueType) : 64;
 
 /* Private method prototypes */
 
    void checkRange(int row, int col);
+   static ValueType *allocateElements(size_t n);
+   static void deallocateElements(ValueType *array);
+   template <typename BlockFunctor>
+   void forEachRowBlock(BlockFunctor fn) const;
+
+/* Grids with fewer elements than this are processed on one thread */
+   static const int MIN_ELEMENTS_PER_THREAD = 16384;
 
 /*
  * Hidden features
@@ -884,19 +3211,24 @@ private:
  * deep copy, making it possible to pass/return grids by value
  * and assign from one grid to another.  The entire contents of
  * the grid, including all elements, are copied.  Each grid
- * element is copied from the original grid to the copy using
- * assignment (operator=).  Making copies is generally avoided
+ * element is copy-constructed from the corresponding element of
+ * the original grid.  Making copies is generally avoided
  * because of the expense and thus, grids are typically passed
  * by reference, however, when a copy is needed, these operations
- * are supported.
+ * are supported.  Returning a grid from a function or assigning
+ * a temporary to it moves the array instead of copying it.
  */
 
    void deepCopy(const Grid & grid) {
-      int n = grid.nRows * grid.nCols;
-      elements = new ValueType[n];
-      for (int i = 0; i < n; i++) {
-         elements[i] = grid.elements[i];
+      size_t n = size_t(grid.nRows) * grid.nCols;
+      elements = allocateElements(n);
+      try {
+         std::uninitialized_copy(grid.elements, grid.elements + n, elements);
+      } catch (...) {
+         deallocateElements(elements);
+         throw;
       }
+      capacity = n;
       nRows = grid.nRows;
       nCols = grid.nCols;
    }
@@ -905,8 +3237,7 @@ public:
 
    Grid & operator=(const Grid & src) {
       if (this != &src) {
-         delete[] elements;
-         deepCopy(src);
+         *this = Grid(src);
       }
       return *this;
    }
@@ -915,6 +3246,33 @@ public:
       deepCopy(src);
    }
 
+   Grid & operator=(Grid && src) noexcept {
+      if (this != &src) {
+         std::destroy(elements, elements + size_t(nRows) * nCols);
+         deallocateElements(elements);
+         elements = src.elements;
+         nRows = src.nRows;
+         nCols = src.nCols;
+         capacity = src.capacity;
+         src.elements = NULL;
+         src.nRows = 0;
+         src.nCols = 0;
+         src.capacity = 0;
+      }
+      return *this;
+   }
+
+   Grid(Grid && src) noexcept {
+      elements = src.elements;
+      nRows = src.nRows;
+      nCols = src.nCols;
+      capacity = src.capacity;
+      src.elements = NULL;
+      src.nRows = 0;
+      src.nCols = 0;
+      src.capacity = 0;
+   }
+
 /*
  * Iterator support
  * ----------------
@@ -991,18 +3349,22 @@ public:
       }
 
       ValueType & operator[](int col) {
+#ifndef GRID_NO_BOUNDS_CHECK
          extern void error(std::string msg);
          if (!gp->inBounds(row, col)) {
             error("Grid::operator [][]: Grid index values out of range");
          }
+#endif
          return gp->elements[(row * gp->nCols) + col];
       }
 
-      ValueType operator[](int col) const {
+      const ValueType & operator[](int col) const {
+#ifndef GRID_NO_BOUNDS_CHECK
          extern void error(std::string msg);
          if (!gp->inBounds(row, col)) {
             error("Grid::operator [][]: Grid index values out of range");
          }
+#endif
          return gp->elements[(row * gp->nCols) + col];
       }
 
@@ -1024,11 +3386,13 @@ public:
            /* Empty */
        }
 
-       const ValueType operator [](int col) const {
+       const ValueType & operator [](int col) const {
+#ifndef GRID_NO_BOUNDS_CHECK
            extern void error(std::string msg);
            if (!gp->inBounds(row, col)) {
               error("Grid::operator [][]: Grid index values out of range");
            }
+#endif
            return gp->elements[(row * gp->nCols) + col];
        }
 
@@ -1050,17 +3414,37 @@ Grid<ValueType>::Grid() {
    elements = NULL;
    nRows = 0;
    nCols = 0;
+   capacity = 0;
 }
 
 template <typename ValueType>
 Grid<ValueType>::Grid(int nRows, int nCols) {
    elements = NULL;
+   this->nRows = 0;
+   this->nCols = 0;
+   capacity = 0;
    resize(nRows, nCols);
 }
 
 template <typename ValueType>
 Grid<ValueType>::~Grid() {
-   if (elements != NULL) delete[] elements;
+   std::destroy(elements, elements + size_t(nRows) * nCols);
+   deallocateElements(elements);
+}
+
+template <typename ValueType>
+ValueType *Grid<ValueType>::allocateElements(size_t n) {
+   if (n == 0) return NULL;
+   void *array = ::operator new(n * sizeof(ValueType),
+                                std::align_val_t(ELEMENT_ALIGNMENT));
+   return static_cast<ValueType *>(array);
+}
+
+template <typename ValueType>
+void Grid<ValueType>::deallocateElements(ValueType *array) {
+   if (array != NULL) {
+      ::operator delete(array, std::align_val_t(ELEMENT_ALIGNMENT));
+   }
 }
 
 template <typename ValueType>
@@ -1073,48 +3457,114 @@ int Grid<ValueType>::numCols() const {
    return nCols;
 }
 
+/*
+ * Implementation notes: resize
+ * ----------------------------
+ * When the contents are discarded, or when only the number of rows
+ * changes, the grid is rebuilt in its current array if the array is
+ * large enough.  Otherwise the new contents are built in a new array
+ * before the old one is released, so that if constructing or copying
+ * an element throws an exception, the grid is left unchanged.  The
+ * retained part of each row is copied as one block, or moved when
+ * that cannot throw.
+ */
+
 template <typename ValueType>
 void Grid<ValueType>::resize(int nRows, int nCols, bool retain) {
+   WCLIB_INSTRUMENT_SCOPE("Grid::resize");
    if (nRows < 0 || nCols < 0) {
       error("Grid::resize: Attempt to resize grid to invalid size ("
             + std::to_string(nRows) + ", "
             + std::to_string(nCols) + ")");
    }
-   // save backup of old array/size
-   ValueType* oldElements = this->elements;
-   int oldnRows = this->nRows;
-   int oldnCols = this->nCols;
-
-   // create new empty array and set new size
+   size_t oldSize = size_t(this->nRows) * this->nCols;
+   size_t newSize = size_t(nRows) * nCols;
+   if (retain && oldSize != 0 && nCols == this->nCols && newSize <= capacity) {
+      if (newSize < oldSize) {
+         std::destroy(elements + newSize, elements + oldSize);
+      } else {
+         std::uninitialized_value_construct(elements + oldSize, elements + newSize);
+      }
+   } else if ((!retain || oldSize == 0) && newSize <= capacity) {
+      this->nRows = 0;
+      this->nCols = 0;
+      std::destroy(elements, elements + oldSize);
+      std::uninitialized_value_construct(elements, elements + newSize);
+   } else {
+      ValueType *newElements = allocateElements(newSize);
+      try {
+         std::uninitialized_value_construct(newElements, newElements + newSize);
+      } catch (...) {
+         deallocateElements(newElements);
+         throw;
+      }
+      if (retain) {
+         int minRows = std::min(this->nRows, nRows);
+         int minCols = std::min(this->nCols, nCols);
+         try {
+            for (int row = 0; row < minRows; row++) {
+               ValueType *src = elements + size_t(row) * this->nCols;
+               ValueType *dst = newElements + size_t(row) * nCols;
+               if constexpr (std::is_nothrow_move_assignable<ValueType>::value) {
+                  std::move(src, src + minCols, dst);
+               } else {
+                  std::copy(src, src + minCols, dst);
+               }
+            }
+         } catch (...) {
+            std::destroy(newElements, newElements + newSize);
+            deallocateElements(newElements);
+            throw;
+         }
+      }
+      std::destroy(elements, elements + oldSize);
+      deallocateElements(elements);
+      elements = newElements;
+      capacity = newSize;
+   }
    this->nRows = nRows;
    this->nCols = nCols;
-   this->elements = new ValueType[nRows * nCols];
-
-   // initialize to empty/default state
-   ValueType value = ValueType();
-   for (int i = 0; i < nRows * nCols; i++) {
-       this->elements[i] = value;
-   }
+}
 
-   // possibly retain old contents
-   if (retain) {
-       int minRows = oldnRows < nRows ? oldnRows : nRows;
-       int minCols = oldnCols < nCols ? oldnCols : nCols;
-       for (int row = 0; row < minRows; row++) {
-           for (int col = 0; col < minCols; col++) {
-               this->elements[(row * nCols) + col] = oldElements[(row * oldnRows) + col];
-           }
-       }
+template <typename ValueType>
+void Grid<ValueType>::reserve(int nRows, int nCols) {
+   WCLIB_INSTRUMENT_SCOPE("Grid::reserve");
+   if (nRows < 0 || nCols < 0) {
+      error("Grid::reserve: Attempt to reserve invalid size ("
+            + std::to_string(nRows) + ", "
+            + std::to_string(nCols) + ")");
    }
-
-   // free old array memory
-   if (oldElements != NULL) {
-       delete[] oldElements;
+   size_t newCapacity = size_t(nRows) * nCols;
+   if (newCapacity <= capacity) return;
+   size_t size = size_t(this->nRows) * this->nCols;
+   ValueType *newElements = allocateElements(newCapacity);
+   try {
+      if constexpr (std::is_nothrow_move_constructible<ValueType>::value) {
+         std::uninitialized_move(elements, elements + size, newElements);
+      } else {
+         std::uninitialized_copy(elements, elements + size, newElements);
+      }
+   } catch (...) {
+      deallocateElements(newElements);
+      throw;
    }
+   std::destroy(elements, elements + size);
+   deallocateElements(elements);
+   elements = newElements;
+   capacity = newCapacity;
 }
 
+/*
+ * Implementation notes: equals
+ * ----------------------------
+ * For types whose values are equal exactly when their bytes are, the
+ * two arrays are compared with memcmp.  Floating-point types do not
+ * qualify, since 0.0 == -0.0 and NaN != NaN.
+ */
+
 template <typename ValueType>
 bool Grid<ValueType>::equals(const Grid<ValueType>& grid2) const {
+    WCLIB_INSTRUMENT_SCOPE("Grid::equals");
     // optimization: if literally same grid, stop
     if (this == &grid2) {
         return true;
@@ -1123,23 +3573,110 @@ bool Grid<ValueType>::equals(const Grid<ValueType>& grid2) const {
     if (nRows != grid2.nRows || nCols != grid2.nCols) {
         return false;
     }
-    for (int row = 0; row < nRows; row++) {
-        for (int col = 0; col < nCols; col++) {
-            if (get(row, col) != grid2.get(row, col)) {
+    size_t n = size_t(nRows) * nCols;
+    if constexpr (std::has_unique_object_representations<ValueType>::value) {
+        return n == 0 || memcmp(elements, grid2.elements, n * sizeof(ValueType)) == 0;
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            if (elements[i] != grid2.elements[i]) {
                 return false;
             }
         }
+        return true;
     }
-    return true;
 }
 
 template <typename ValueType>
 void Grid<ValueType>::fill(const ValueType& value) {
+    WCLIB_INSTRUMENT_SCOPE("Grid::fill");
     for (int i = 0; i < nRows * nCols; i++) {
         elements[i] = value;
     }
 }
 
+template <typename ValueType>
+void Grid<ValueType>::saveBinary(const std::string& filename) const {
+   WCLIB_INSTRUMENT_SCOPE("Grid::saveBinary");
+   static_assert(std::is_trivially_copyable<ValueType>::value,
+                 "Grid::saveBinary requires a trivially copyable element type");
+   GridFileHeader header;
+   memset(&header, 0, sizeof header);
+   memcpy(header.magic, "GRID", 4);
+   header.byteOrder = GRID_BYTE_ORDER_MARK;
+   header.nRows = nRows;
+   header.nCols = nCols;
+   header.elementSize = sizeof(ValueType);
+   std::ofstream out(filename.c_str(), std::ios::binary);
+   if (!out) error("Grid::saveBinary: Couldn't open file " + filename);
+   out.write(reinterpret_cast<const char *>(&header), sizeof header);
+   out.write(reinterpret_cast<const char *>(elements),
+             size_t(nRows) * nCols * sizeof(ValueType));
+   out.close();
+   if (out.fail()) error("Grid::saveBinary: Couldn't write file " + filename);
+}
+
+/*
+ * Implementation notes: loadBinary
+ * --------------------------------
+ * The elements are read straight into the array.  Because the element
+ * type is trivially copyable, the slots need no construction first,
+ * so the grid is not value-initialized only to be overwritten.  The
+ * header is not trusted: the element count must not overflow, and the
+ * file must hold exactly that many elements, before anything is
+ * allocated.
+ */
+
+template <typename ValueType>
+void Grid<ValueType>::loadBinary(const std::string& filename) {
+   WCLIB_INSTRUMENT_SCOPE("Grid::loadBinary");
+   static_assert(std::is_trivially_copyable<ValueType>::value,
+                 "Grid::loadBinary requires a trivially copyable element type");
+   std::ifstream in(filename.c_str(), std::ios::binary);
+   if (!in) error("Grid::loadBinary: Couldn't open file " + filename);
+   GridFileHeader header;
+   if (!in.read(reinterpret_cast<char *>(&header), sizeof header)
+       || memcmp(header.magic, "GRID", 4) != 0) {
+      error("Grid::loadBinary: Improperly formed grid file " + filename);
+   }
+   if (header.byteOrder != GRID_BYTE_ORDER_MARK) {
+      error("Grid::loadBinary: Grid file " + filename
+            + " was written with a different byte order");
+   }
+   if (header.elementSize != sizeof(ValueType)) {
+      error("Grid::loadBinary: Grid file " + filename
+            + " holds elements of a different size");
+   }
+   if (header.nRows > unsigned(INT_MAX) || header.nCols > unsigned(INT_MAX)) {
+      error("Grid::loadBinary: Improperly formed grid file " + filename);
+   }
+   size_t n = size_t(header.nRows) * header.nCols;
+   if ((header.nCols != 0 && n / header.nCols != header.nRows)
+       || n > SIZE_MAX / sizeof(ValueType)) {
+      error("Grid::loadBinary: Improperly formed grid file " + filename);
+   }
+   std::streampos dataStart = in.tellg();
+   in.seekg(0, std::ios::end);
+   std::streamoff remaining = in.tellg() - dataStart;
+   in.seekg(dataStart);
+   if (!in || remaining < 0 || uint64_t(remaining) != n * sizeof(ValueType)) {
+      error("Grid::loadBinary: Grid file " + filename
+            + " does not match the size in its header");
+   }
+   nRows = 0;
+   nCols = 0;
+   if (n > capacity) {
+      ValueType *newElements = allocateElements(n);
+      deallocateElements(elements);
+      elements = newElements;
+      capacity = n;
+   }
+   if (!in.read(reinterpret_cast<char *>(elements), n * sizeof(ValueType))) {
+      error("Grid::loadBinary: Grid file " + filename + " is truncated");
+   }
+   nRows = header.nRows;
+   nCols = header.nCols;
+}
+
 template <typename ValueType>
 bool Grid<ValueType>::inBounds(int row, int col) const {
    return row >= 0 && col >= 0 && row < nRows && col < nCols;
@@ -1180,6 +3717,33 @@ Grid<ValueType>::operator [](int row) const {
     return GridRowConst(const_cast<Grid*>(this), row);
 }
 
+template <typename ValueType>
+GridSpan<ValueType> Grid<ValueType>::row(int row) {
+   if (row < 0 || row >= nRows) error("Grid::row: Grid row index out of range");
+   return GridSpan<ValueType>(elements + size_t(row) * nCols, nCols);
+}
+
+template <typename ValueType>
+GridSpan<const ValueType> Grid<ValueType>::row(int row) const {
+   if (row < 0 || row >= nRows) error("Grid::row: Grid row index out of range");
+   return GridSpan<const ValueType>(elements + size_t(row) * nCols, nCols);
+}
+
+template <typename ValueType>
+ValueType *Grid<ValueType>::data() {
+   return elements;
+}
+
+template <typename ValueType>
+const ValueType *Grid<ValueType>::data() const {
+   return elements;
+}
+
+template <typename ValueType>
+int Grid<ValueType>::stride() const {
+   return nCols;
+}
+
 template <typename ValueType>
 bool Grid<ValueType>::operator ==(const Grid& grid2) const {
     return equals(grid2);
@@ -1218,6 +3782,158 @@ void Grid<ValueType>::mapAll(FunctorType fn) const {
    }
 }
 
+/*
+ * Implementation notes: forEachRowBlock
+ * -------------------------------------
+ * Splits the rows into one block per thread and calls fn(begin, end)
+ * for each block, running the first block on the calling thread.  The
+ * number of threads is limited so that each one has a reasonable
+ * amount of work.  An exception thrown in a block is held until every
+ * thread has finished.
+ */
+
+template <typename ValueType>
+template <typename BlockFunctor>
+void Grid<ValueType>::forEachRowBlock(BlockFunctor fn) const {
+   size_t nElements = size_t(nRows) * nCols;
+   size_t nThreads = std::thread::hardware_concurrency();
+   nThreads = std::min(nThreads, nElements / MIN_ELEMENTS_PER_THREAD);
+   nThreads = std::min(nThreads, size_t(nRows));
+   if (nThreads <= 1) {
+      if (nRows > 0) fn(0, nRows);
+      return;
+   }
+   std::vector<std::exception_ptr> failures(nThreads);
+   auto runBlock = [&](size_t i) {
+      int begin = int(nRows * i / nThreads);
+      int end = int(nRows * (i + 1) / nThreads);
+      try {
+         fn(begin, end);
+      } catch (...) {
+         failures[i] = std::current_exception();
+      }
+   };
+   std::vector<std::thread> threads;
+   threads.reserve(nThreads - 1);
+   for (size_t i = 1; i < nThreads; i++) {
+      threads.emplace_back(runBlock, i);
+   }
+   runBlock(0);
+   for (std::thread& thread : threads) {
+      thread.join();
+   }
+   for (std::exception_ptr& failure : failures) {
+      if (failure) std::rethrow_exception(failure);
+   }
+}
+
+template <typename ValueType>
+template <typename FunctorType>
+void Grid<ValueType>::parallelForEach(FunctorType fn) {
+   WCLIB_INSTRUMENT_SCOPE("Grid::parallelForEach");
+   forEachRowBlock([this, &fn](int begin, int end) {
+      ValueType *p = elements + size_t(begin) * nCols;
+      ValueType *last = elements + size_t(end) * nCols;
+      for (; p != last; p++) {
+         fn(*p);
+      }
+   });
+}
+
+template <typename ValueType>
+template <typename FunctorType>
+void Grid<ValueType>::parallelForEach(FunctorType fn) const {
+   WCLIB_INSTRUMENT_SCOPE("Grid::parallelForEach");
+   forEachRowBlock([this, &fn](int begin, int end) {
+      const ValueType *p = elements + size_t(begin) * nCols;
+      const ValueType *last = elements + size_t(end) * nCols;
+      for (; p != last; p++) {
+         fn(*p);
+      }
+   });
+}
+
+template <typename ValueType>
+template <typename ResultType, typename FunctorType>
+void Grid<ValueType>::transform(Grid<ResultType>& dst, FunctorType fn) const {
+   WCLIB_INSTRUMENT_SCOPE("Grid::transform");
+   if (dst.numRows() != nRows || dst.numCols() != nCols) {
+      dst.resize(nRows, nCols);
+   }
+   ResultType *out = dst.data();
+   forEachRowBlock([this, out, &fn](int begin, int end) {
+      size_t first = size_t(begin) * nCols;
+      size_t last = size_t(end) * nCols;
+      for (size_t i = first; i < last; i++) {
+         out[i] = fn(elements[i]);
+      }
+   });
+}
+
+template <typename ValueType>
+template <typename T, typename BinaryOp>
+T Grid<ValueType>::reduce(T init, BinaryOp op) const {
+   WCLIB_INSTRUMENT_SCOPE("Grid::reduce");
+   std::vector<std::pair<int, T> > partials;
+   std::mutex partialsLock;
+   forEachRowBlock([this, &op, &partials, &partialsLock](int begin, int end) {
+      const ValueType *p = elements + size_t(begin) * nCols;
+      const ValueType *last = elements + size_t(end) * nCols;
+      if (p == last) return;
+      T partial = T(*p++);
+      for (; p != last; p++) {
+         partial = op(partial, *p);
+      }
+      std::lock_guard<std::mutex> guard(partialsLock);
+      partials.emplace_back(begin, partial);
+   });
+   std::sort(partials.begin(), partials.end(),
+             [](const std::pair<int, T>& a, const std::pair<int, T>& b) {
+                return a.first < b.first;
+             });
+   for (const std::pair<int, T>& partial : partials) {
+      init = op(init, partial.second);
+   }
+   return init;
+}
+
+/*
+ * Implementation notes: stencil
+ * -----------------------------
+ * The threads share this grid read-only, so the halo rows that each
+ * block needs from its neighbors are simply read in place.  Cells at
+ * least radius away from every edge are marked as interior, which lets
+ * their neighbors be read without a bounds check.
+ */
+
+template <typename ValueType>
+template <typename ResultType, typename FunctorType>
+void Grid<ValueType>::stencil(Grid<ResultType>& dst, int radius, FunctorType fn,
+                              const ValueType& outside) const {
+   WCLIB_INSTRUMENT_SCOPE("Grid::stencil");
+   if (static_cast<const void *>(&dst) == static_cast<const void *>(this)) {
+      error("Grid::stencil: Destination must be a different grid");
+   }
+   if (radius < 0) error("Grid::stencil: radius must be non-negative");
+   if (dst.numRows() != nRows || dst.numCols() != nCols) {
+      dst.resize(nRows, nCols);
+   }
+   ResultType *out = dst.data();
+   forEachRowBlock([this, out, radius, &fn, &outside](int begin, int end) {
+      Neighborhood n(this, &outside);
+      for (int r = begin; r < end; r++) {
+         bool interiorRow = r >= radius && r < nRows - radius;
+         ResultType *outRow = out + size_t(r) * nCols;
+         n.cellRow = r;
+         for (int c = 0; c < nCols; c++) {
+            n.cellCol = c;
+            n.interior = interiorRow && c >= radius && c < nCols - radius;
+            outRow[c] = fn(static_cast<const Neighborhood&>(n));
+         }
+      }
+   });
+}
+
 template <typename ValueType>
 std::string Grid<ValueType>::toString() {
    std::ostringstream os;
@@ -1273,17 +3989,32 @@ std::ostream & operator<<(std::ostream & os, const Grid<ValueType> & grid) {
 //    return is;
 // }
 
+/*
+ * Hash function for raw memory, computing the 64-bit xxHash of the
+ * bytes.  The result depends on the byte order of the machine.
+ */
+uint64_t hashBytes(const void *data, size_t length, uint64_t seed = 0);
+
 /*
  * Template hash function for grids.
- * Requires the element type in the Grid to have a hashCode function.
+ * Requires the element type in the Grid to have a hashCode function,
+ * except for types whose values are equal exactly when their bytes
+ * are, which are hashed directly from the array together with the
+ * dimensions of the grid.
  */
 template <typename T>
 int hashCode(const Grid<T>& g) {
-    int code = HASH_SEED;
-    for (T n : g) {
-        code = HASH_MULTIPLIER * code + hashCode(n);
+    if constexpr (std::has_unique_object_representations<T>::value) {
+        uint64_t seed = (uint64_t(g.numRows()) << 32) | uint32_t(g.numCols());
+        uint64_t code = hashBytes(g.data(), size_t(g.numRows()) * g.numCols() * sizeof(T), seed);
+        return int((code ^ (code >> 32)) & HASH_MASK);
+    } else {
+        unsigned code = HASH_SEED;
+        for (const T& n : g) {
+            code = HASH_MULTIPLIER * code + hashCode(n);
+        }
+        return int(code & HASH_MASK);
     }
-    return int(code & HASH_MASK);
 }
 
 #endif
\ No newline at end of file